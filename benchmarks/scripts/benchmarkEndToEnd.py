@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+Reproducible end-to-end benchmark of ratarmount's hot paths for each compression backend.
+
+Archives with a seeded file count and file size distribution are generated once in the work folder and then
+mounted in-process with TarMount, whose methods are what FUSE calls for each syscall. This avoids noise from the
+kernel and the FUSE layer and needs no permissions for mounting. For each backend, it measures:
+
+ - the cold mount time, i.e., including the index creation, and the warm mount time with an existing index,
+ - the exact getattr latency percentiles for random files,
+ - the random and sequential read throughput with multiple concurrent readers calling TarMount.read in chunks of
+   128 KiB like FUSE does,
+ - the read amplification, i.e., the estimated decoded bytes per requested byte, and the cache hit rates as
+   reported by /.ratarmount-stats. The read amplification is only estimated with --cache-size 0 because else
+   the block cache hit rate shows how much decoding is avoided.
+
+One JSON object per backend is appended to the output file, or printed, so that the results of different releases
+can be compared. Backends, whose compression modules are not installed, are reported with an error.
+
+Usage: benchmarkEndToEnd.py [--files 10000] [--size-distribution lognormal] [--readers 4] [--output results.jsonl]
+"""
+
+import argparse
+import bz2
+import gzip
+import io
+import json
+import lzma
+import math
+import os
+import platform
+import random
+import shutil
+import subprocess
+import sys
+import tarfile
+import threading
+import time
+
+sys.path.insert( 0, os.path.join( os.path.dirname( os.path.abspath( __file__ ) ), '..', '..' ) )
+
+import ratarmount  # noqa: E402
+
+
+FUSE_READ_SIZE = 128 * 1024
+# Uncompressed size of the independently compressed xz streams and zstd frames, so that both are seekable.
+FRAME_SIZE = 1024 * 1024
+
+
+def generateFileSizes( fileCount, distribution, meanSize, seed ):
+    generator = random.Random( seed )
+    if distribution == 'fixed':
+        return [ meanSize ] * fileCount
+    if distribution == 'lognormal':
+        # The median is a quarter of the mean, which results in many small and a few large files.
+        sigma = math.sqrt( 2 * math.log( 4 ) )
+        return [ int( generator.lognormvariate( 0, sigma ) * meanSize / 4 ) for _ in range( fileCount ) ]
+    if distribution == 'mixed':
+        # 99 % small files and 1 % files 100 times as large, e.g., a dataset with some videos.
+        smallSize = max( 1, int( meanSize / ( 0.99 + 0.01 * 100 ) ) )
+        return [ smallSize * 100 if generator.random() < 0.01 else smallSize for _ in range( fileCount ) ]
+    raise ValueError( "Unknown file size distribution: " + distribution )
+
+def generateContents( generator, size ):
+    """Returns data, which is compressible approximately by a factor of 2 like many real files."""
+    randomSize = size // 2
+    randomData = generator.getrandbits( 8 * randomSize ).to_bytes( randomSize, 'little' ) if randomSize else b''
+    return randomData + b'\0' * ( size - randomSize )
+
+def createTar( path, fileSizes, seed, filesPerFolder = 100 ):
+    generator = random.Random( seed )
+    with tarfile.open( path, 'w' ) as tarFile:
+        for i, size in enumerate( fileSizes ):
+            tarInfo = tarfile.TarInfo( "data/{:05d}/file{:08d}.bin".format( i // filesPerFolder, i ) )
+            tarInfo.size = size
+            tarFile.addfile( tarInfo, io.BytesIO( generateContents( generator, size ) ) )
+
+def compressInFrames( inputPath, outputPath, compressFrame ):
+    with open( inputPath, 'rb' ) as inputFile, open( outputPath, 'wb' ) as outputFile:
+        while True:
+            frame = inputFile.read( FRAME_SIZE )
+            if not frame:
+                break
+            outputFile.write( compressFrame( frame ) )
+
+def compressZstdFrame( frame ):
+    try:
+        import zstandard
+        return zstandard.ZstdCompressor().compress( frame )
+    except ImportError:
+        return subprocess.run( [ 'zstd', '-q', '-c' ], input = frame, stdout = subprocess.PIPE, check = True ).stdout
+
+def compressTar( tarPath, compression ):
+    """Returns the path to the compressed TAR, which is only created if it does not exist yet."""
+    if compression == 'none':
+        return tarPath
+
+    compressedPath = tarPath + '.' + compression
+    if os.path.exists( compressedPath ):
+        return compressedPath
+
+    temporaryPath = compressedPath + '.tmp'
+    if compression in [ 'gz', 'bz2' ]:
+        openCompressed = gzip.open if compression == 'gz' else bz2.open
+        with open( tarPath, 'rb' ) as inputFile, openCompressed( temporaryPath, 'wb' ) as outputFile:
+            shutil.copyfileobj( inputFile, outputFile )
+    elif compression == 'xz':
+        # Concatenated xz streams are valid xz files and each of them can be decoded on its own.
+        compressInFrames( tarPath, temporaryPath, lambda frame: lzma.compress( frame, format = lzma.FORMAT_XZ ) )
+    elif compression == 'zst':
+        compressInFrames( tarPath, temporaryPath, compressZstdFrame )
+    else:
+        raise ValueError( "Unknown compression: " + compression )
+    os.rename( temporaryPath, compressedPath )
+    return compressedPath
+
+def percentile( sortedValues, fraction ):
+    return sortedValues[min( len( sortedValues ) - 1, int( fraction * len( sortedValues ) ) )]
+
+class Benchmark:
+    def __init__( self, archivePath, paths, fileSizes, args ):
+        self.archivePath = archivePath
+        self.paths = paths
+        self.fileSizes = fileSizes
+        self.args = args
+        self.mountPoint = archivePath + '.mountpoint'
+
+    def mount( self ):
+        return ratarmount.TarMount(
+            self.archivePath,
+            self.mountPoint,
+            threaded = self.args.readers > 1,
+            parallelization = self.args.parallelization,
+            blockCache = ratarmount.BlockCache( self.args.cache_size ) if self.args.cache_size > 0 else None,
+            prefetch = self.args.prefetch,
+        )
+
+    @staticmethod
+    def unmount( tarMount ):
+        # The mount point is closed and removed when the TarMount object is destroyed.
+        for mountSource in tarMount.mountSources:
+            mountSource.close()
+
+    def measureMountTimes( self ):
+        indexPath = self.archivePath + '.index.sqlite'
+        if os.path.exists( indexPath ):
+            os.remove( indexPath )
+
+        t0 = time.time()
+        self.unmount( self.mount() )
+        t1 = time.time()
+        tarMount = self.mount()
+        t2 = time.time()
+        return tarMount, { 'coldMountSeconds': t1 - t0, 'warmMountSeconds': t2 - t1 }
+
+    def measureGetattr( self, tarMount ):
+        generator = random.Random( self.args.seed )
+        latencies = []
+        for path in generator.choices( self.paths, k = self.args.getattr_calls ):
+            t0 = time.perf_counter()
+            tarMount.getattr( path )
+            latencies.append( time.perf_counter() - t0 )
+        latencies.sort()
+        return {
+            'getattrP50Us': percentile( latencies, 0.5 ) * 1e6,
+            'getattrP99Us': percentile( latencies, 0.99 ) * 1e6,
+            'getattrMeanUs': sum( latencies ) / len( latencies ) * 1e6,
+        }
+
+    def runReaders( self, tarMount, readerFunction ):
+        """Calls readerFunction( tarMount, readerIndex ) in each reader thread and returns the throughput in MB/s."""
+        results = [ 0 ] * self.args.readers
+
+        def reader( index ):
+            results[index] = readerFunction( tarMount, index )
+
+        threads = [ threading.Thread( target = reader, args = ( i, ) ) for i in range( self.args.readers ) ]
+        t0 = time.time()
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        t1 = time.time()
+        return sum( results ) / ( t1 - t0 ) / 1e6
+
+    def randomReader( self, tarMount, index ):
+        """Reads one chunk at a random offset of randomly chosen files and returns the number of bytes read."""
+        generator = random.Random( self.args.seed + 1 + index )
+        bytesRead = 0
+        for _ in range( self.args.random_reads // self.args.readers ):
+            i = generator.randrange( len( self.paths ) )
+            offset = generator.randrange( max( 1, self.fileSizes[i] ) ) // FUSE_READ_SIZE * FUSE_READ_SIZE
+            bytesRead += len( tarMount.read( self.paths[i], FUSE_READ_SIZE, offset, 0 ) )
+        return bytesRead
+
+    def sequentialReader( self, tarMount, index ):
+        """Reads a contiguous slice of all files completely in the order they are stored in the archive."""
+        sliceSize = ( len( self.paths ) + self.args.readers - 1 ) // self.args.readers
+        bytesRead = 0
+        for i in range( index * sliceSize, min( len( self.paths ), ( index + 1 ) * sliceSize ) ):
+            for offset in range( 0, self.fileSizes[i], FUSE_READ_SIZE ):
+                bytesRead += len( tarMount.read( self.paths[i], FUSE_READ_SIZE, offset, 0 ) )
+        return bytesRead
+
+    def measureReads( self, tarMount, name, readerFunction ):
+        ratarmount.performanceStatistics.clear()
+        if tarMount.blockCache:
+            tarMount.blockCache.clear()
+
+        result = { name + 'MBps': self.runReaders( tarMount, readerFunction ) }
+        statsSize = tarMount.getattr( '/.ratarmount-stats' )['st_size']
+        statistics = json.loads( tarMount.read( '/.ratarmount-stats', statsSize, 0, 0 ) )
+        result[name + 'Amplification'] = statistics.get( 'decoderAmplification' )
+        result[name + 'BlockCacheHitRate'] = statistics.get( 'blockCache', {} ).get( 'hitRate' )
+        result[name + 'ReadP99Us'] = statistics['latencies'].get( 'fuse.read', {} ).get( 'p99Us' )
+        return result
+
+    def run( self ):
+        tarMount, result = self.measureMountTimes()
+        try:
+            result.update( self.measureGetattr( tarMount ) )
+            result.update( self.measureReads( tarMount, 'randomRead', self.randomReader ) )
+            result.update( self.measureReads( tarMount, 'sequentialRead', self.sequentialReader ) )
+        finally:
+            self.unmount( tarMount )
+        return result
+
+def parseArgs():
+    parser = argparse.ArgumentParser(
+        description = __doc__, formatter_class = argparse.RawDescriptionHelpFormatter )
+    parser.add_argument( '--compressions', default = 'none,gz,bz2,zst,xz',
+                         help = 'Comma-separated list of the compression backends to benchmark.' )
+    parser.add_argument( '--files', type = int, default = 10000, help = 'Number of files in the archive.' )
+    parser.add_argument( '--size-distribution', default = 'lognormal', choices = [ 'fixed', 'lognormal', 'mixed' ] )
+    parser.add_argument( '--mean-size', type = int, default = 64 * 1024, help = 'Mean file size in bytes.' )
+    parser.add_argument( '--seed', type = int, default = 0 )
+    parser.add_argument( '--readers', type = int, default = 4, help = 'Number of concurrent reader threads.' )
+    parser.add_argument( '--random-reads', type = int, default = 2000 )
+    parser.add_argument( '--getattr-calls', type = int, default = 10000 )
+    parser.add_argument( '--parallelization', type = int, default = 1 )
+    parser.add_argument( '--cache-size', type = int, default = 128 * 1024 * 1024 )
+    parser.add_argument( '--prefetch', type = int, default = 0 )
+    parser.add_argument( '--work-dir', default = 'benchmark-archives',
+                         help = 'Folder for the generated archives, which are reused by later runs.' )
+    parser.add_argument( '--output', help = 'JSON Lines file to append the results to. Default: stdout' )
+    return parser.parse_args()
+
+def benchmarkEndToEnd():
+    args = parseArgs()
+    ratarmount.printDebug = 0
+
+    fileSizes = generateFileSizes( args.files, args.size_distribution, args.mean_size, args.seed )
+    os.makedirs( args.work_dir, exist_ok = True )
+    tarPath = os.path.join( args.work_dir, 'files-{}-{}-{}-{}.tar'.format(
+        args.files, args.size_distribution, args.mean_size, args.seed ) )
+    if not os.path.exists( tarPath ):
+        createTar( tarPath + '.tmp', fileSizes, args.seed )
+        os.rename( tarPath + '.tmp', tarPath )
+    paths = [ "/data/{:05d}/file{:08d}.bin".format( i // 100, i ) for i in range( len( fileSizes ) ) ]
+
+    parameters = { key: value for key, value in vars( args ).items() if key not in [ 'output', 'work_dir' ] }
+    for compression in args.compressions.split( ',' ):
+        result = {
+            'ratarmount': ratarmount.__version__,
+            'python': platform.python_version(),
+            'platform': platform.platform(),
+            'time': time.strftime( '%Y-%m-%dT%H:%M:%S' ),
+            'compression': compression,
+            'parameters': parameters,
+            'totalFileSize': sum( fileSizes ),
+        }
+        try:
+            archivePath = compressTar( tarPath, compression )
+            result['archiveSize'] = os.stat( archivePath ).st_size
+            result.update( Benchmark( archivePath, paths, fileSizes, args ).run() )
+        except Exception as exception:
+            result['error'] = "{}: {}".format( type( exception ).__name__, exception )
+
+        line = json.dumps( result )
+        if args.output:
+            with open( args.output, 'a' ) as file:
+                file.write( line + '\n' )
+        print( line )
+
+
+benchmarkEndToEnd()
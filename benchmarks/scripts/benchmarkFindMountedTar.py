@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+Compares the lookup of the recursively mounted TAR for a path in FolderMountSource._findMountedTar using the
+mount point trie with the former implementation, which probed the mount point dictionary for each path prefix.
+
+Usage: benchmarkFindMountedTar.py [number of mounted TARs]
+"""
+
+import os
+import random
+import sys
+import tempfile
+import time
+
+sys.path.insert( 0, os.path.join( os.path.dirname( os.path.abspath( __file__ ) ), '..', '..' ) )
+
+from ratarmount import FolderMountSource  # noqa: E402
+
+
+def findMountedTarByPrefixes( tarFilePaths, path ):
+    """The former implementation of FolderMountSource._findMountedTar."""
+    if not tarFilePaths:
+        return None
+
+    parts = path.lstrip( os.path.sep ).split( os.path.sep )
+    subPath = ""
+    for i, part in enumerate( parts ):
+        subPath = os.path.join( subPath, part )
+        if subPath in tarFilePaths:
+            pathInsideTar = os.path.join( *parts[i + 1 :] ) if i + 1 < len( parts ) else "/"
+            return subPath, pathInsideTar
+    return None
+
+def benchmarkFindMountedTar( nTars = 50 * 1000, folderDepth = 8 ):
+    folder = tempfile.mkdtemp()
+    mountSource = FolderMountSource( folder )
+
+    random.seed( 0 )
+    mountPoints = []
+    for i in range( nTars ):
+        depth = random.randint( 1, folderDepth )
+        parents = [ "folder{}".format( random.randint( 0, 9 ) ) for _ in range( depth - 1 ) ]
+        mountPoints.append( os.path.join( *parents, "archive{}.tar".format( i ) ) )
+        # The path to the TAR is only used for stat'ing the mount point.
+        mountSource._addMountPoint( mountPoints[-1], folder )
+
+    # FUSE calls getattr on all parent folders and then on the files inside the mounted TARs.
+    paths = []
+    for mountPoint in random.sample( mountPoints, 10000 ):
+        paths.append( '/' + os.path.dirname( mountPoint ) )
+        paths.append( '/' + mountPoint )
+        paths.append( '/' + mountPoint + "/some/folder/inside/the/archive/file.txt" )
+
+    for path in paths:
+        assert mountSource._findMountedTar( path ) == findMountedTarByPrefixes( mountSource.tarFilePaths, path )
+
+    t0 = time.time()
+    for path in paths:
+        findMountedTarByPrefixes( mountSource.tarFilePaths, path )
+    t1 = time.time()
+    print( "Prefix probing: {} lookups with {} mounted TARs took {:.3f} s -> {:.2f} us per lookup".format(
+        len( paths ), nTars, t1 - t0, ( t1 - t0 ) / len( paths ) * 1e6 ) )
+
+    t0 = time.time()
+    for path in paths:
+        mountSource._findMountedTar( path )
+    t1 = time.time()
+    print( "Mount point trie: {} lookups with {} mounted TARs took {:.3f} s -> {:.2f} us per lookup".format(
+        len( paths ), nTars, t1 - t0, ( t1 - t0 ) / len( paths ) * 1e6 ) )
+
+    os.rmdir( folder )
+
+
+benchmarkFindMountedTar( int( sys.argv[1] ) if len( sys.argv ) > 1 else 50 * 1000 )
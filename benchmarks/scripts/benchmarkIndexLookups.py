@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+Measures the metadata lookup latencies of SQLiteIndexedTar for the different index memory modes with access
+patterns like those of 'find' and of many independent 'stat' calls, e.g., by a build system or rsync.
+
+Usage: benchmarkIndexLookups.py [number of files]
+"""
+
+import io
+import os
+import random
+import sys
+import tarfile
+import tempfile
+import time
+
+sys.path.insert( 0, os.path.join( os.path.dirname( os.path.abspath( __file__ ) ), '..', '..' ) )
+
+import ratarmount  # noqa: E402
+from ratarmount import SQLiteIndexedTar  # noqa: E402
+
+
+def createTar( path, nFiles, filesPerFolder = 100 ):
+    with tarfile.open( path, 'w' ) as tarFile:
+        for i in range( nFiles ):
+            iFolder = i // filesPerFolder
+            tarInfo = tarfile.TarInfo( "data/{:03d}/{:05d}/file{:08d}.jpg".format( iFolder // 100, iFolder, i ) )
+            tarFile.addfile( tarInfo, io.BytesIO() )
+
+def find( archive, path = '/' ):
+    """Lists all folders recursively and stats each entry like find or ls -lR."""
+    count = 0
+    for name in archive.getFileInfo( path, listDir = True ):
+        filePath = path.rstrip( '/' ) + '/' + name
+        fileInfo = archive.getFileInfo( filePath )
+        count += 1
+        if fileInfo.mode & 0o040000:
+            count += find( archive, filePath )
+    return count
+
+def benchmarkIndexLookups( nFiles = 1000 * 1000 ):
+    ratarmount.printDebug = 0
+    folder = tempfile.mkdtemp()
+    tarPath = os.path.join( folder, 'files.tar' )
+    createTar( tarPath, nFiles )
+
+    # Create the index once, so that only its loading is measured below.
+    SQLiteIndexedTar( tarPath, writeIndex = True ).close()
+    print( "Index size for {} files: {:.1f} MiB".format(
+        nFiles, os.stat( tarPath + '.index.sqlite' ).st_size / 1024**2 ) )
+
+    with tarfile.open( tarPath ) as tarFile:
+        paths = [ '/' + name for name in tarFile.getnames() ]
+    random.seed( 0 )
+    random.shuffle( paths )
+    paths = paths[:100 * 1000]
+
+    for mode in [ 'disk', 'mmap', 'memory' ]:
+        t0 = time.time()
+        archive = SQLiteIndexedTar( tarPath, writeIndex = True, indexMemoryMode = mode )
+        t1 = time.time()
+        print( "[{}] Opening the index took {:.3f} s".format( mode, t1 - t0 ) )
+
+        t0 = time.time()
+        for path in paths:
+            archive.getFileInfo( path )
+        t1 = time.time()
+        print( "[{}] stat storm: {} lookups of random files took {:.3f} s -> {:.1f} us per lookup".format(
+            mode, len( paths ), t1 - t0, ( t1 - t0 ) / len( paths ) * 1e6 ) )
+
+        t0 = time.time()
+        count = find( archive )
+        t1 = time.time()
+        print( "[{}] find: listing and stating {} entries took {:.3f} s -> {:.1f} us per entry".format(
+            mode, count, t1 - t0, ( t1 - t0 ) / count * 1e6 ) )
+
+        archive.close()
+
+    os.remove( tarPath + '.index.sqlite' )
+    os.remove( tarPath )
+    os.rmdir( folder )
+
+
+benchmarkIndexLookups( int( sys.argv[1] ) if len( sys.argv ) > 1 else 1000 * 1000 )
@@ -126,10 +126,195 @@ def benchmarkCacheSizesSortAfter( nFiles = 1000 * 1000 ):
     fig.savefig( fname + ".pdf" )
     fig.savefig( fname + ".png" )
 
+def benchmarkInsertBatchSizes( nFiles = 1000 * 1000 ):
+    """
+    Compares inserting rows of the ratarmount "files" schema one by one with inserting them in batches
+    of different sizes using executemany, similar to SQLiteIndexedTar._flushFileInfos.
+    """
+    fname = "sqlite insert batch size benchmark {}k files".format( nFiles // 1000 )
+
+    batchSizes = [ 1, 10, 100, 1000, 10000, 100000 ]
+    rowsPerSecond = []
+    for batchSize in batchSizes:
+        databaseFile = tempfile.mkstemp()[1]
+        db = sqlite3.connect( databaseFile )
+        db.executescript( """
+            PRAGMA LOCKING_MODE = EXCLUSIVE;
+            PRAGMA TEMP_STORE = MEMORY;
+            PRAGMA JOURNAL_MODE = OFF;
+            PRAGMA SYNCHRONOUS = OFF;
+        """ )
+        db.execute( """
+            CREATE TABLE "files" (
+                "path"          VARCHAR(65535) NOT NULL,
+                "name"          VARCHAR(65535) NOT NULL,
+                "offsetheader"  INTEGER,
+                "offset"        INTEGER,
+                "size"          INTEGER,
+                "mtime"         INTEGER,
+                "mode"          INTEGER,
+                "type"          INTEGER,
+                "linkname"      VARCHAR(65535),
+                "uid"           INTEGER,
+                "gid"           INTEGER,
+                "istar"         BOOL   ,
+                "issparse"      BOOL   ,
+                PRIMARY KEY (path,name,offsetheader)
+            );
+        """ )
+
+        # Generate the rows beforehand in order to exclude the PRNG time. Use files sorted into folders
+        # like they most often appear inside TARs.
+        rows = [ ( "/{:05d}".format( i // 1000 ), "{:096d}".format( i ), 512 * i, 512 * i + 512,
+                   0, 0, 0o100644, 0, "", 1000, 1000, False, False ) for i in range( nFiles ) ]
+
+        t0 = time.time()
+        if batchSize == 1:
+            for row in rows:
+                db.execute( 'INSERT OR REPLACE INTO "files" VALUES (' + ','.join( '?' * len( row ) ) + ');', row )
+        else:
+            for i in range( 0, nFiles, batchSize ):
+                db.executemany( 'INSERT OR REPLACE INTO "files" VALUES (' + ','.join( '?' * len( rows[0] ) ) + ');',
+                                rows[i:i + batchSize] )
+        db.commit()
+        t1 = time.time()
+
+        rowsPerSecond += [ nFiles / ( t1 - t0 ) ]
+        print( "Inserting {} rows with batch size {} took {:.3f} s -> {:.0f} rows/s".
+               format( nFiles, batchSize, t1 - t0, rowsPerSecond[-1] ) )
+
+        db.close()
+        os.remove( databaseFile )
+
+    fig = plt.figure()
+    ax = fig.add_subplot( 111, xlabel = "Rows per executemany", ylabel = "Insertion Rate / (rows/s)", xscale = 'log' )
+
+    ax.plot( batchSizes, rowsPerSecond, 'o' )
+
+    fig.tight_layout()
+    fig.savefig( fname + ".pdf" )
+    fig.savefig( fname + ".png" )
+
+def benchmarkCompactSchema( nFiles = 1000 * 1000, folderDepth = 8 ):
+    """
+    Compares the index size and the lookup latencies of the default "files" schema, which stores the full parent
+    path in each row, with the compact schema of SQLiteIndexedTar, which interns the parent paths into a
+    "directories" table and stores the rows in a WITHOUT ROWID table keyed by the integer directory id.
+    """
+    fname = "sqlite compact schema benchmark {}k files".format( nFiles // 1000 )
+
+    columns = """
+        "offsetheader"  INTEGER,
+        "offset"        INTEGER,
+        "size"          INTEGER,
+        "mtime"         INTEGER,
+        "mode"          INTEGER,
+        "type"          INTEGER,
+        "linkname"      VARCHAR(65535),
+        "uid"           INTEGER,
+        "gid"           INTEGER,
+        "istar"         BOOL   ,
+        "issparse"      BOOL   ,
+    """
+    schemas = {
+        'path,name,offsetheader': """
+            CREATE TABLE "files" (
+                "path"          VARCHAR(65535) NOT NULL,
+                "name"          VARCHAR(65535) NOT NULL,
+                {}
+                PRIMARY KEY (path,name,offsetheader)
+            );
+        """.format( columns ),
+        'dirid,name,offsetheader without rowid': """
+            CREATE TABLE "directories" (
+                "id"            INTEGER PRIMARY KEY,
+                "path"          VARCHAR(65535) NOT NULL UNIQUE
+            );
+            CREATE TABLE "compactfiles" (
+                "dirid"         INTEGER NOT NULL,
+                "name"          VARCHAR(65535) NOT NULL,
+                {}
+                PRIMARY KEY (dirid,name,offsetheader)
+            ) WITHOUT ROWID;
+            CREATE VIEW "files" AS
+                SELECT "directories"."path" AS "path", "compactfiles"."name" AS "name",
+                       "offsetheader", "offset", "size", "mtime", "mode", "type", "linkname", "uid", "gid",
+                       "istar", "issparse"
+                FROM "compactfiles" JOIN "directories" ON "compactfiles"."dirid" == "directories"."id";
+        """.format( columns ),
+    }
+
+    # Deep hierarchies with 100 files per folder like, e.g., source code or data set archives.
+    filesPerFolder = 100
+    def makePath( iFolder ):
+        return "/" + "/".join( "folder{:04d}".format( ( iFolder >> ( 2 * level ) ) % 4 + 4 * level )
+                               for level in range( folderDepth ) ) + "/{:06d}".format( iFolder )
+    rows = [ ( makePath( i // filesPerFolder ), "file{:08d}.jpg".format( i ), 512 * i, 512 * i + 512,
+               1000, 0, 0o100644, 0, "", 1000, 1000, False, False ) for i in range( nFiles ) ]
+
+    nLookups = 10000
+    lookups = [ rows[i] for i in np.random.randint( 0, nFiles, nLookups ) ]
+
+    for label, schema in schemas.items():
+        databaseFile = tempfile.mkstemp()[1]
+        db = sqlite3.connect( databaseFile )
+        db.executescript( """
+            PRAGMA LOCKING_MODE = EXCLUSIVE;
+            PRAGMA TEMP_STORE = MEMORY;
+            PRAGMA JOURNAL_MODE = OFF;
+            PRAGMA SYNCHRONOUS = OFF;
+        """ )
+        db.executescript( schema )
+
+        t0 = time.time()
+        if 'dirid' in label:
+            directoryIds = {}
+            for i in range( 0, nFiles, 1000 ):
+                batch = []
+                for row in rows[i:i + 1000]:
+                    if row[0] not in directoryIds:
+                        directoryIds[row[0]] = db.execute( 'INSERT INTO "directories" ("path") VALUES (?)',
+                                                           ( row[0], ) ).lastrowid
+                    batch.append( ( directoryIds[row[0]], ) + row[1:] )
+                db.executemany( 'INSERT OR REPLACE INTO "compactfiles" VALUES (' + ','.join( '?' * 13 ) + ');',
+                                batch )
+        else:
+            for i in range( 0, nFiles, 1000 ):
+                db.executemany( 'INSERT OR REPLACE INTO "files" VALUES (' + ','.join( '?' * 13 ) + ');',
+                                rows[i:i + 1000] )
+        db.commit()
+        t1 = time.time()
+        db.close()
+        print( "[{}] Inserting {} rows took {:.3f} s, index size: {:.1f} MiB".
+               format( label, nFiles, t1 - t0, os.stat( databaseFile ).st_size / 1024**2 ) )
+
+        # Reopen the database in order to start with a cold SQLite page cache.
+        db = sqlite3.connect( databaseFile )
+
+        t0 = time.time()
+        for row in lookups:
+            db.execute( 'SELECT * FROM "files" WHERE "path" == (?) AND "name" == (?) '
+                        'ORDER BY "offsetheader" DESC LIMIT 1;', row[:2] ).fetchone()
+        t1 = time.time()
+        print( "[{}] Looking up {} files took {:.3f} s -> {:.1f} us per lookup".
+               format( label, nLookups, t1 - t0, ( t1 - t0 ) / nLookups * 1e6 ) )
+
+        t0 = time.time()
+        for row in lookups:
+            db.execute( 'SELECT * FROM "files" WHERE "path" == (?)', row[:1] ).fetchall()
+        t1 = time.time()
+        print( "[{}] Listing {} folders took {:.3f} s -> {:.1f} us per listing".
+               format( label, nLookups, t1 - t0, ( t1 - t0 ) / nLookups * 1e6 ) )
+
+        db.close()
+        os.remove( databaseFile )
+
 
 benchmarkCacheSizesSortAfter( 1000 * 1000 )
 #benchmarkCacheSizesSortAfter( 1000 * 1000 )
 #benchmarkCacheSizes( 128 * 1000 )
+#benchmarkInsertBatchSizes( 1000 * 1000 )
+#benchmarkCompactSchema( 1000 * 1000 )
 
 plt.show()
 exit()
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+Compares the time for iterating over all members of an uncompressed TAR with tarfile and with the
+TarHeaderScanner used by SQLiteIndexedTar for creating the index. Both ustar and PAX archives are tested
+because the latter require an additional extended header per member with long names.
+
+Usage: benchmarkTarHeaderScanner.py [number of files]
+"""
+
+import io
+import os
+import sys
+import tarfile
+import tempfile
+import time
+
+sys.path.insert( 0, os.path.join( os.path.dirname( os.path.abspath( __file__ ) ), '..', '..' ) )
+
+import ratarmount  # noqa: E402
+from ratarmount import SQLiteIndexedTar, TarHeaderScanner  # noqa: E402
+
+
+def createTar( path, nFiles, tarFormat, nameLength ):
+    with tarfile.open( path, 'w', format = tarFormat ) as tarFile:
+        for i in range( nFiles ):
+            name = "data/{:05d}/file{:08d}".format( i // 1000, i )
+            tarInfo = tarfile.TarInfo( name + 'x' * max( 0, nameLength - len( name ) ) )
+            tarInfo.size = i % 1000
+            tarFile.addfile( tarInfo, io.BytesIO( b'0' * tarInfo.size ) )
+
+def iterateTarfile( path ):
+    with open( path, 'rb' ) as file:
+        return sum( 1 for _ in tarfile.open( fileobj = file, mode = 'r:' ) )
+
+def iterateScanner( path ):
+    with open( path, 'rb' ) as file:
+        return sum( 1 for _ in TarHeaderScanner( file ) )
+
+def benchmarkTarHeaderScanner( nFiles = 100 * 1000, repetitions = 3 ):
+    ratarmount.printDebug = 0
+    folder = tempfile.mkdtemp()
+    tarPath = os.path.join( folder, 'files.tar' )
+
+    for tarFormat, formatName, nameLength in [ ( tarfile.USTAR_FORMAT, 'ustar', 0 ),
+                                               ( tarfile.PAX_FORMAT, 'pax', 120 ) ]:
+        createTar( tarPath, nFiles, tarFormat, nameLength )
+
+        for name, iterate in [ ( 'tarfile', iterateTarfile ), ( 'TarHeaderScanner', iterateScanner ) ]:
+            times = []
+            for _ in range( repetitions ):
+                t0 = time.time()
+                count = iterate( tarPath )
+                times.append( time.time() - t0 )
+            assert count == nFiles
+            print( "[{}] Iterating {} members with {} took {:.3f} s -> {:.2f} us per member".format(
+                formatName, count, name, min( times ), min( times ) / count * 1e6 ) )
+
+        t0 = time.time()
+        SQLiteIndexedTar( tarPath, writeIndex = True, clearIndexCache = True ).close()
+        t1 = time.time()
+        print( "[{}] Creating the index took {:.3f} s".format( formatName, t1 - t0 ) )
+
+        os.remove( tarPath + '.index.sqlite' )
+        os.remove( tarPath )
+
+    os.rmdir( folder )
+
+
+benchmarkTarHeaderScanner( int( sys.argv[1] ) if len( sys.argv ) > 1 else 100 * 1000 )
@@ -4,20 +4,51 @@
 import argparse
 import bisect
 import collections
+import concurrent.futures
+import contextlib
+import email.utils
+import functools
+import hashlib
+import hmac
+import inspect
 import io
 import json
+import lzma
+import mmap
 import os
 import re
+import shutil
 import sqlite3
 import stat
+import struct
 import sys
 import tarfile
 import tempfile
+import threading
 import time
 import traceback
+import urllib.error
+import urllib.parse
+import urllib.request
+import zlib
 from timeit import default_timer as timer
 import typing
-from typing import Any, AnyStr, BinaryIO, Dict, IO, Iterable, List, Optional, Set, Tuple, Union
+from typing import (
+    Any,
+    AnyStr,
+    BinaryIO,
+    Callable,
+    Dict,
+    IO,
+    Iterable,
+    Iterator,
+    List,
+    Optional,
+    Sequence,
+    Set,
+    Tuple,
+    Union,
+)
 
 import fuse
 
@@ -44,6 +75,14 @@ except ImportError:
 __version__ = '0.7.0'
 
 
+def _fileDescriptorOrObject(fileobj: Any) -> Any:
+    """Returns the file descriptor for decoders preferring it or the file object itself if it has none."""
+    try:
+        return fileobj.fileno()
+    except (OSError, ValueError, AttributeError):
+        return fileobj
+
+
 # Defining lambdas does not yet check the names of entities used inside the lambda!
 CompressionInfo = collections.namedtuple(
     'CompressionInfo', ['suffixes', 'doubleSuffixes', 'moduleName', 'checkHeader', 'open']
@@ -54,7 +93,7 @@ supportedCompressions = {
         ['tb2', 'tbz', 'tbz2', 'tz2'],
         'indexed_bzip2',
         lambda x: (x.read(4)[:3] == b'BZh' and x.read(6) == (0x314159265359).to_bytes(6, 'big')),
-        lambda x: indexed_bzip2.IndexedBzip2File(x.fileno()),
+        lambda x: indexed_bzip2.IndexedBzip2File(_fileDescriptorOrObject(x)),
     ),
     'gz': CompressionInfo(
         ['gz', 'gzip'],
@@ -63,15 +102,16 @@ supportedCompressions = {
         lambda x: x.read(2) == b'\x1F\x8B',
         lambda x: indexed_gzip.IndexedGzipFile(fileobj=x),
     ),
-    'xz': CompressionInfo(
-        ['xz'], ['txz'], 'lzmaffi', lambda x: x.read(6) == b"\xFD7zXZ\x00", lambda x: lzmaffi.open(x)
-    ),
+    'xz': CompressionInfo(['xz'], ['txz'], 'lzma', lambda x: x.read(6) == b"\xFD7zXZ\x00", lambda x: openXzFile(x)),
     'zst': CompressionInfo(
         ['zst', 'zstd'],
         ['tzst'],
         'indexed_zstd',
-        lambda x: x.read(4) == (0xFD2FB528).to_bytes(4, 'little'),
-        lambda x: indexed_zstd.IndexedZstdFile(x.fileno()),
+        # Files created by pzstd start with a skippable frame
+        lambda x: (lambda magic: magic == 0xFD2FB528 or magic & 0xFFFFFFF0 == 0x184D2A50)(
+            int.from_bytes(x.read(4), 'little')
+        ),
+        lambda x: indexed_zstd.IndexedZstdFile(_fileDescriptorOrObject(x)),
     ),
 }
 
@@ -103,6 +143,42 @@ def stripSuffixFromTarFile(path: str) -> str:
     return path
 
 
+def findSplitArchiveParts(path: str) -> List[str]:
+    """
+    Returns the paths to all parts of a split archive, e.g., archive.tar.001, archive.tar.002, ..., if the given path
+    is the first part of one. Else, returns only the given path. The parts must be numbered consecutively with
+    a fixed number of digits starting from 0 or 1 as is done by, e.g., split -d or 7-Zip.
+    """
+    match = re.fullmatch(r'(.*\.)(\d{2,})', path)
+    # Split remote archives are not supported because finding the parts would require requests for each of them.
+    if not match or int(match.group(2)) > 1 or isRemotePath(path):
+        return [path]
+
+    prefix, number = match.group(1), match.group(2)
+    parts = [path]
+    while True:
+        part = prefix + str(int(number) + len(parts)).zfill(len(number))
+        if not os.path.isfile(part):
+            break
+        parts.append(part)
+    return parts
+
+
+def isRemotePath(path: Any) -> bool:
+    """Returns true for URLs of archives, which are read with RemoteFile instead of from the file system."""
+    return isinstance(path, str) and re.match(r'(https?|s3)://', path, re.IGNORECASE) is not None
+
+
+def statPath(path: str) -> os.stat_result:
+    """Like os.stat but also works for URLs of remote files."""
+    return RemoteFile.stat(path) if isRemotePath(path) else os.stat(path)
+
+
+def openPath(path: str) -> IO[bytes]:
+    """Opens the local file or the URL of a remote file for reading."""
+    return typing.cast(IO[bytes], RemoteFile(path)) if isRemotePath(path) else open(path, 'rb')
+
+
 printDebug = 1
 
 
@@ -122,6 +198,10 @@ class CompressionError(RatarmountError):
     """Exception for trying to open files with unsupported compression or unavailable decompression module."""
 
 
+class RemoteError(RatarmountError):
+    """Exception for remote files, which can't be read, e.g., because the server does not support ranged requests."""
+
+
 def overrides(parentClass):
     """Simple decorator that checks that a method with the same name exists in the parent class"""
 
@@ -136,6 +216,9 @@ def overrides(parentClass):
 class ProgressBar:
     """Simple progress bar which keeps track of changes and prints the progress and a time estimate."""
 
+    # Disabled in the worker processes for parallel index creation. The main process shows the combined progress.
+    enabled = True
+
     def __init__(self, maxValue: float):
         # fmt: off
         self.maxValue        = maxValue
@@ -147,6 +230,8 @@ class ProgressBar:
 
     def update(self, value: float) -> None:
         """Should be called whenever the monitored value changes. The progress bar is updated accordingly."""
+        if not self.enabled:
+            return
         if self.lastUpdateTime is not None and (time.time() - self.lastUpdateTime) < self.updateInterval:
             return
 
@@ -173,7 +258,11 @@ class ProgressBar:
 
 
 class StenciledFile(io.BufferedIOBase):
-    """A file abstraction layer giving a stenciled view to an underlying file."""
+    """
+    A file abstraction layer giving a stenciled view to an underlying file.
+    Stencils are looked up by bisection of their cumulative sizes, so that views over many fragments, e.g.,
+    multi-part archives, are still cheap to read from.
+    """
 
     def __init__(self, fileobj: IO, stencils: List[Tuple[int, int]]) -> None:
         """
@@ -245,31 +334,58 @@ class StenciledFile(io.BufferedIOBase):
 
     @overrides(io.BufferedIOBase)
     def read(self, size: int = -1) -> bytes:
-        if size == -1:
-            size = self.cumsizes[-1] - self.offset
+        if size is None or size < 0 or self.offset + size > self.cumsizes[-1]:
+            size = max(0, self.cumsizes[-1] - self.offset)
+        if size == 0:
+            return b''
 
-        # This loop works in a kind of leapfrog fashion. On each even loop iteration it seeks to the next stencil
-        # and on each odd iteration it reads the data and increments the offset inside the stencil!
-        result = b''
+        # Most reads, e.g., of files inside a TAR, are inside one stencil and can be forwarded without any copy.
         i = self._findStencil(self.offset)
-        while size > 0 and i < len(self.sizes):
-            # Read as much as requested or as much as the current contiguous region / stencil still contains
-            readableSize = min(size, self.sizes[i] - (self.offset - self.cumsizes[i]))
-            if readableSize == 0:
-                # Go to next stencil
-                i += 1
-                if i >= len(self.offsets):
-                    break
-                self.fileobj.seek(self.offsets[i])
+        offsetInsideStencil = self.offset - self.cumsizes[i]
+        if offsetInsideStencil + size <= self.sizes[i]:
+            self.fileobj.seek(self.offsets[i] + offsetInsideStencil, io.SEEK_SET)
+            data = self.fileobj.read(size)
+            self.offset += len(data)
+            return data
+
+        # Fill one preallocated buffer instead of concatenating the results of each stencil.
+        result = bytearray(size)
+        readSize = self.readinto(result)
+        if readSize < size:
+            del result[readSize:]
+        return bytes(result)
+
+    @overrides(io.BufferedIOBase)
+    def readinto(self, buffer: Any) -> int:
+        view = memoryview(buffer).cast('B')
+        size = min(len(view), max(0, self.cumsizes[-1] - self.offset))
+        if size == 0:
+            return 0
+
+        readSize = 0
+        i = self._findStencil(self.offset)
+        readinto = getattr(self.fileobj, 'readinto', None)
+        while readSize < size and i < len(self.sizes):
+            # Read as much as requested or as much as the current contiguous region / stencil still contains.
+            # Always seek because the underlying file object might be shared with other users.
+            offsetInsideStencil = self.offset - self.cumsizes[i]
+            chunkSize = min(size - readSize, self.sizes[i] - offsetInsideStencil)
+            self.fileobj.seek(self.offsets[i] + offsetInsideStencil, io.SEEK_SET)
+            if readinto:
+                chunkReadSize = readinto(view[readSize : readSize + chunkSize])
             else:
-                # Actually read data
-                tmp = self.fileobj.read(readableSize)
-                self.offset += len(tmp)
-                result += tmp
-                size -= readableSize
-                # Now, either size is 0 or readableSize will be 0 in the next iteration
+                data = self.fileobj.read(chunkSize)
+                chunkReadSize = len(data)
+                view[readSize : readSize + chunkReadSize] = data
 
-        return result
+            if not chunkReadSize:
+                break
+            readSize += chunkReadSize
+            self.offset += chunkReadSize
+            if chunkReadSize == chunkSize:
+                i += 1
+
+        return readSize
 
     @overrides(io.BufferedIOBase)
     def seek(self, offset: int, whence: int = io.SEEK_SET) -> int:
@@ -298,167 +414,2193 @@ class StenciledFile(io.BufferedIOBase):
         return self.offset
 
 
-# Names must be identical to the SQLite column headers!
-FileInfo = collections.namedtuple(
-    "FileInfo", "offsetheader offset size mtime mode type linkname uid gid istar issparse"
-)
+class JoinedFile(io.BufferedIOBase):
+    """
+    A read-only and seekable view of several file objects concatenated in the given order, e.g., the parts of
+    a split archive. The file objects are owned and closed by this object.
+    """
+
+    def __init__(self, fileobjs: List[IO[bytes]], name: Optional[str] = None) -> None:
+        # fmt: off
+        self.fileobjs = fileobjs
+        self.name     = name if name else getattr(fileobjs[0], 'name', '<joined file>') if fileobjs else ''
+        self.offset   = 0
+        # fmt: on
 
+        # Calculate cumulative sizes
+        self.cumsizes = [0]
+        for fileobj in fileobjs:
+            self.cumsizes.append(self.cumsizes[-1] + fileobj.seek(0, io.SEEK_END))
 
-class SQLiteIndexedTar:
+    def _findPart(self, offset: int) -> int:
+        """Returns the index of the file object containing the given offset. See StenciledFile._findStencil."""
+        return bisect.bisect_right(self.cumsizes, offset) - 1
+
+    @overrides(io.BufferedIOBase)
+    def close(self) -> None:
+        for fileobj in self.fileobjs:
+            fileobj.close()
+        super().close()
+
+    @overrides(io.BufferedIOBase)
+    def seekable(self) -> bool:
+        return True
+
+    @overrides(io.BufferedIOBase)
+    def readable(self) -> bool:
+        return True
+
+    @overrides(io.BufferedIOBase)
+    def writable(self) -> bool:
+        return False
+
+    @overrides(io.BufferedIOBase)
+    def read(self, size: int = -1) -> bytes:
+        if size is None or size < 0 or self.offset + size > self.cumsizes[-1]:
+            size = max(0, self.cumsizes[-1] - self.offset)
+
+        result = bytearray(size)
+        readSize = self.readinto(result)
+        if readSize < size:
+            del result[readSize:]
+        return bytes(result)
+
+    @overrides(io.BufferedIOBase)
+    def readinto(self, buffer: Any) -> int:
+        view = memoryview(buffer).cast('B')
+        size = min(len(view), max(0, self.cumsizes[-1] - self.offset))
+
+        readSize = 0
+        i = self._findPart(self.offset)
+        while readSize < size and i < len(self.fileobjs):
+            offsetInsidePart = self.offset - self.cumsizes[i]
+            chunkSize = min(size - readSize, self.cumsizes[i + 1] - self.offset)
+            fileobj = self.fileobjs[i]
+            fileobj.seek(offsetInsidePart)
+            chunkReadSize = fileobj.readinto(view[readSize : readSize + chunkSize])  # type: ignore
+            if not chunkReadSize:
+                break
+            readSize += chunkReadSize
+            self.offset += chunkReadSize
+            if chunkReadSize == chunkSize:
+                i += 1
+
+        return readSize
+
+    @overrides(io.BufferedIOBase)
+    def seek(self, offset: int, whence: int = io.SEEK_SET) -> int:
+        if whence == io.SEEK_CUR:
+            offset += self.offset
+        elif whence == io.SEEK_END:
+            offset += self.cumsizes[-1]
+        if offset < 0:
+            raise ValueError("Trying to seek before the start of the file!")
+        self.offset = offset
+        return self.offset
+
+    @overrides(io.BufferedIOBase)
+    def tell(self) -> int:
+        return self.offset
+
+
+class RemoteFile(io.BufferedIOBase):
     """
-    This class reads once through the whole TAR archive and stores TAR file offsets
-    for all contained files in an index to support fast seeking to a given file.
+    A read-only and seekable file object for an HTTP(S) or S3 URL, which only fetches the requested parts of the
+    remote object with ranged GET requests. The object is fetched in chunks of chunkSize, which are cached in memory
+    and, if cacheSize is not 0, on disk in cacheFolder, so that mounting again or reading the same members again
+    does not fetch anything. Adjacent missing chunks are fetched with one request and sequential reads, e.g., for
+    creating the index, fetch increasingly many chunks ahead.
+
+    S3 URLs, i.e., s3://bucket/key, are requested path-style from the endpoint in AWS_ENDPOINT_URL or else from AWS.
+    The requests are signed with AWS signature version 4 if AWS_ACCESS_KEY_ID and AWS_SECRET_ACCESS_KEY are set.
     """
 
-    # Version 0.1.0:
-    #   - Initial version
-    # Version 0.2.0:
-    #   - Add sparse support and 'offsetheader' and 'issparse' columns to the SQLite database
-    #   - Add TAR file size metadata in order to quickly check whether the TAR changed
-    #   - Add 'offsetheader' to the primary key of the 'files' table so that files which were
-    #     updated in the TAR can still be accessed if necessary.
-    # Version 0.3.0:
-    #   - Add arguments influencing the created index to metadata (ignore-zeros, recursive, ...)
-    __version__ = '0.3.0'
+    # fmt: off
+    # The folder for the on-disk chunk cache and for downloaded indexes. It can be deleted at any time.
+    cacheFolder: Optional[str] = os.path.join(os.path.expanduser('~'), '.ratarmount', 'remote-cache')
+    # The maximum size of all chunks in the on-disk cache in bytes. 0 disables the on-disk chunk cache.
+    # The least recently used chunks are deleted when it is exceeded.
+    cacheSize      = 0
+    chunkSize      = 1024 * 1024
+    maxReadAhead   = 32  # chunks
+    timeout        = 60  # seconds
+    retries        = 3
+    # fmt: on
 
-    def __init__(
+    # Maps URLs to their size, modification time, and ETag, so that opening the same URL again needs no request.
+    _metadata: Dict[str, Tuple[int, float, str]] = {}
+    _metadataLock = threading.Lock()
+    # The size of the on-disk chunk cache as counted by this process. It is None until it has been determined from
+    # the cache folder and only an estimate because other processes might use the same cache folder.
+    _cacheUsage: Optional[int] = None
+    _cacheLock = threading.Lock()
+
+    def __init__(self, url: str) -> None:
         # fmt: off
-        self,
-        tarFileName                : Optional[str]       = None,
-        fileObject                 : Optional[BinaryIO]  = None,
-        writeIndex                 : bool                = False,
-        clearIndexCache            : bool                = False,
-        indexFileName              : Optional[str]       = None,
-        indexFolders               : Optional[List[str]] = None,
-        recursive                  : bool                = False,
-        gzipSeekPointSpacing       : int                 = 4*1024*1024,
-        encoding                   : str                 = tarfile.ENCODING,
-        stripRecursiveTarExtension : bool                = False,
-        ignoreZeros                : bool                = False,
-        verifyModificationTime     : bool                = False,
+        self.url           = url
+        self.name          = url
+        self.offset        = 0
+        self.lock          = threading.Lock()
+        self.memoryCache   = BlockCache(8 * self.chunkSize, self.chunkSize)
+        self.readAhead     = 0
+        self.lastFetched   = -1
+        # Can be disabled for reads, which are not expected to be repeated, e.g., the one pass for creating the index.
+        self.persistChunks = True
+        self.fileSize, self.mtime, self.etag = RemoteFile._getMetadata(url)
         # fmt: on
-    ) -> None:
+
+        # A changed remote object gets a new chunk folder instead of using possibly outdated chunks and the chunk
+        # folders of the outdated versions are deleted.
+        self.chunkFolder: Optional[str] = None
+        if RemoteFile.cacheFolder and RemoteFile.cacheSize > 0:
+            objectFolder = os.path.join(
+                RemoteFile._chunksFolder(), hashlib.sha256(RemoteFile.stripQuery(url).encode()).hexdigest()[:32]
+            )
+            version = json.dumps([self.fileSize, self.mtime, self.etag, self.chunkSize])
+            self.chunkFolder = os.path.join(objectFolder, hashlib.sha256(version.encode()).hexdigest()[:32])
+            try:
+                staleFolders = [os.path.join(objectFolder, folder) for folder in os.listdir(objectFolder)]
+            except OSError:
+                staleFolders = []
+            for folder in staleFolders:
+                if folder != self.chunkFolder:
+                    shutil.rmtree(folder, ignore_errors=True)
+                    with RemoteFile._cacheLock:
+                        RemoteFile._cacheUsage = None
+
+    @staticmethod
+    def _chunksFolder() -> str:
+        return os.path.join(typing.cast(str, RemoteFile.cacheFolder), 'chunks')
+
+    @staticmethod
+    def stripQuery(url: str) -> str:
+        """Removes the query, which might contain changing signatures of presigned URLs, for identifying the object."""
+        return urllib.parse.urlunsplit(urllib.parse.urlsplit(url)._replace(query='', fragment=''))
+
+    @staticmethod
+    def _request(url: str, begin: int, end: int, etag: str = '') -> Any:
         """
-        tarFileName : Path to the TAR file to be opened. If not specified, a fileObject must be specified.
-                      If only a fileObject is given, the created index can't be cached (efficiently).
-        fileObject : A io.IOBase derived object. If not specified, tarFileName will be opened.
-                     If it is an instance of IndexedBzip2File, IndexedGzipFile, or IndexedZstdFile, then the offset
-                     loading and storing from and to the SQLite database is managed automatically by this class.
-        encoding : Will be forwarded to tarfile. Specifies how filenames inside the TAR are encoded.
-        ignoreZeros : Will be forwarded to tarfile. Specifies to not only skip zero blocks but also blocks with
-                      invalid data. Setting this to true can lead to some problems but is required to correctly
-                      read concatenated tars.
-        stripRecursiveTarExtension : If true and if recursive is also true, then a <file>.tar inside the current
-                                     tar will be mounted at <file>/ instead of <file>.tar/.
+        Returns the response for the byte range [begin, end] of the given URL. If an ETag is given, the server is
+        asked to fail the request with 412 Precondition Failed if the remote object does not have it anymore.
         """
+        requestUrl = url
+        headers = {'Range': 'bytes={}-{}'.format(begin, end)}
+        if etag:
+            headers['If-Match'] = etag
+        parsed = urllib.parse.urlsplit(url)
+        if parsed.scheme.lower() == 's3':
+            region = os.environ.get('AWS_REGION', os.environ.get('AWS_DEFAULT_REGION', 'us-east-1'))
+            endpoint = os.environ.get('AWS_ENDPOINT_URL', 'https://s3.{}.amazonaws.com'.format(region)).rstrip('/')
+            path = '/' + parsed.netloc + urllib.parse.quote(parsed.path, safe='/~')
+            requestUrl = endpoint + path + ('?' + parsed.query if parsed.query else '')
+            if 'AWS_ACCESS_KEY_ID' in os.environ and 'AWS_SECRET_ACCESS_KEY' in os.environ:
+                RemoteFile._signS3Request(requestUrl, headers, region)
+
+        for attempt in range(RemoteFile.retries):
+            try:
+                return urllib.request.urlopen(
+                    urllib.request.Request(requestUrl, headers=headers), timeout=RemoteFile.timeout
+                )
+            except urllib.error.HTTPError as exception:
+                if exception.code < 500 or attempt + 1 >= RemoteFile.retries:
+                    raise
+            except (urllib.error.URLError, OSError):
+                if attempt + 1 >= RemoteFile.retries:
+                    raise
+            time.sleep(0.5 * 2**attempt)
+        raise RemoteError("Could not request " + url)
 
-        # stores which parent folders were last tried to add to database and therefore do exist
-        self.parentFolderCache: List[Tuple[str, str]] = []
-        self.sqlConnection: Optional[sqlite3.Connection] = None
+    @staticmethod
+    def _signS3Request(url: str, headers: Dict[str, str], region: str) -> None:
+        """Adds the headers for the AWS signature version 4 to the headers of a GET request without a payload."""
+        parsed = urllib.parse.urlsplit(url)
+        amzDate = time.strftime('%Y%m%dT%H%M%SZ', time.gmtime())
+        signedHeaders = {
+            'host': parsed.netloc,
+            'x-amz-content-sha256': 'UNSIGNED-PAYLOAD',
+            'x-amz-date': amzDate,
+        }
+        if 'AWS_SESSION_TOKEN' in os.environ:
+            signedHeaders['x-amz-security-token'] = os.environ['AWS_SESSION_TOKEN']
+
+        query = sorted(urllib.parse.parse_qsl(parsed.query, keep_blank_values=True))
+        canonicalRequest = '\n'.join(
+            [
+                'GET',
+                parsed.path or '/',
+                urllib.parse.urlencode(query, quote_via=urllib.parse.quote, safe='~'),
+                ''.join('{}:{}\n'.format(key, value) for key, value in sorted(signedHeaders.items())),
+                ';'.join(sorted(signedHeaders)),
+                'UNSIGNED-PAYLOAD',
+            ]
+        )
+        scope = '{}/{}/s3/aws4_request'.format(amzDate[:8], region)
+        stringToSign = '\n'.join(
+            ['AWS4-HMAC-SHA256', amzDate, scope, hashlib.sha256(canonicalRequest.encode()).hexdigest()]
+        )
 
-        # fmt: off
-        self.mountRecursively           = recursive
-        self.encoding                   = encoding
-        self.stripRecursiveTarExtension = stripRecursiveTarExtension
-        self.ignoreZeros                = ignoreZeros
-        self.verifyModificationTime     = verifyModificationTime
-        self.gzipSeekPointSpacing       = gzipSeekPointSpacing
-        # fmt: on
+        key = ('AWS4' + os.environ['AWS_SECRET_ACCESS_KEY']).encode()
+        for message in [amzDate[:8], region, 's3', 'aws4_request']:
+            key = hmac.new(key, message.encode(), hashlib.sha256).digest()
+        signature = hmac.new(key, stringToSign.encode(), hashlib.sha256).hexdigest()
 
-        if not tarFileName:
-            if not fileObject:
-                raise ValueError("At least one of tarFileName and fileObject arguments should be set!")
-            self.tarFileName = '<file object>'
-            self._createIndex(fileObject)
-            # return here because we can't find a save location without any identifying name
-            return
+        del signedHeaders['host']
+        headers.update(signedHeaders)
+        headers['Authorization'] = 'AWS4-HMAC-SHA256 Credential={}/{}, SignedHeaders={}, Signature={}'.format(
+            os.environ['AWS_ACCESS_KEY_ID'], scope, ';'.join(sorted(list(signedHeaders) + ['host'])), signature
+        )
 
-        self.tarFileName = os.path.abspath(tarFileName)
-        fileSize = None
-        if not fileObject:
-            fileObject = open(self.tarFileName, 'rb')
-            fileObject.seek(0, io.SEEK_END)
-            fileSize = fileObject.tell()
-            fileObject.seek(0)
+    @staticmethod
+    def _getMetadata(url: str) -> Tuple[int, float, str]:
+        """Returns the size, modification time, and ETag of the remote object."""
+        with RemoteFile._metadataLock:
+            if url in RemoteFile._metadata:
+                return RemoteFile._metadata[url]
 
-        # rawFileObject : Only set when opening a compressed file and only kept to keep the
-        #                 compressed file handle from being closed by the garbage collector.
-        # tarFileObject : File object to the uncompressed (or decompressed) TAR file to read actual data out of.
-        # compression   : Stores what kind of compression the originally specified TAR file uses.
-        # isTar         : Can be false for the degenerated case of only a bz2 or gz file not containing a TAR
-        self.tarFileObject, self.rawFileObject, self.compression, self.isTar = SQLiteIndexedTar._openCompressedFile(
-            fileObject, gzipSeekPointSpacing, encoding
+        # A ranged GET also works for presigned URLs, which are only valid for GET and not for HEAD requests.
+        try:
+            response = RemoteFile._request(url, 0, 0)
+            contentRange = response.headers.get('Content-Range', '')
+            response.close()
+        except urllib.error.HTTPError as exception:
+            # Ranges can't be satisfied for empty objects.
+            if exception.code != 416:
+                raise
+            response = exception
+            contentRange = exception.headers.get('Content-Range', 'bytes */0')
+
+        match = re.fullmatch(r'bytes [0-9*-]+/([0-9]+)', contentRange.strip())
+        if response.status == 200 or not match:
+            raise RemoteError("The server for {} does not support ranged requests!".format(url))
+
+        lastModified = response.headers.get('Last-Modified')
+        metadata = (
+            int(match.group(1)),
+            email.utils.parsedate_to_datetime(lastModified).timestamp() if lastModified else 0.0,
+            response.headers.get('ETag', ''),
         )
+        with RemoteFile._metadataLock:
+            RemoteFile._metadata[url] = metadata
+        return metadata
 
-        if self.compression == 'xz':
+    @staticmethod
+    def _requestUnchanged(url: str, begin: int, end: int, size: int, etag: str) -> bytes:
+        """
+        Returns the byte range [begin, end] of the given URL and raises a RemoteError if the remote object does not
+        have the given size and ETag anymore, because the data would not fit to the already fetched parts of it.
+        Servers ignoring If-Match are detected by checking the ETag and the total size in Content-Range.
+        """
+        try:
+            with RemoteFile._request(url, begin, end, etag) as response:
+                data = response.read()
+                contentRange = response.headers.get('Content-Range', '')
+                responseTag = response.headers.get('ETag', '')
+        except urllib.error.HTTPError as exception:
+            if exception.code != 412:
+                raise
+            contentRange = ''
+            responseTag = None
+
+        match = re.fullmatch(r'bytes [0-9]+-[0-9]+/([0-9]+)', contentRange.strip())
+        if responseTag is None or (match and int(match.group(1)) != size) or (etag and responseTag not in ('', etag)):
+            # Opening the URL again should see the new version instead of the cached metadata.
+            with RemoteFile._metadataLock:
+                RemoteFile._metadata.pop(url, None)
+            raise RemoteError("The remote object {} changed while it was being read!".format(url))
+        if len(data) != end + 1 - begin:
+            raise RemoteError("Got {} B instead of {} B from {}!".format(len(data), end + 1 - begin, url))
+        return data
+
+    @staticmethod
+    def stat(url: str) -> os.stat_result:
+        """Returns the size and modification time of the remote object like os.stat for a read-only file."""
+        size, mtime, _ = RemoteFile._getMetadata(url)
+        # fmt: off
+        return os.stat_result((
+            stat.S_IFREG | 0o444, 0, 0, 1, os.getuid(), os.getgid(), size, int(mtime), int(mtime), int(mtime)
+        ))
+        # fmt: on
+
+    @staticmethod
+    def download(url: str, path: str) -> bool:
+        """
+        Downloads the remote object to the given local path if it has changed since the last download.
+        Returns false if the remote object does not exist.
+        """
+        try:
+            size, mtime, etag = RemoteFile._getMetadata(url)
+        except urllib.error.HTTPError as exception:
+            if exception.code in (403, 404):
+                return False
+            raise
+
+        if os.path.isfile(path) and os.stat(path).st_size == size and os.stat(path).st_mtime == int(mtime):
+            return True
+
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        with tempfile.NamedTemporaryFile(dir=os.path.dirname(path), delete=False) as file:
             try:
-                if len(self.tarFileObject.block_boundaries) <= 1 and (fileSize is None or fileSize > 1024 * 1024):
-                    print("[Warning] The specified file '{}'".format(self.tarFileName))
-                    print("[Warning] is compressed using xz but only contains one xz block. This makes it ")
-                    print("[Warning] impossible to use true seeking! Please (re)compress your TAR using pixz")
-                    print("[Warning] (see https://github.com/vasi/pixz) in order for ratarmount to do be able ")
-                    print("[Warning] to do fast seeking to requested files.")
-                    print("[Warning] As it is, each file access will decompress the whole TAR from the beginning!")
-                    print()
+                for begin in range(0, size, 16 * RemoteFile.chunkSize):
+                    end = min(size, begin + 16 * RemoteFile.chunkSize) - 1
+                    file.write(RemoteFile._requestUnchanged(url, begin, end, size, etag))
             except Exception:
-                pass
+                file.close()
+                os.remove(file.name)
+                raise
+        os.replace(file.name, path)
+        os.utime(path, (int(mtime), int(mtime)))
+        return True
 
-        # will be used for storing indexes if current path is read-only
-        possibleIndexFilePaths = [self.tarFileName + ".index.sqlite"]
-        indexPathAsName = self.tarFileName.replace("/", "_") + ".index.sqlite"
-        if isinstance(indexFolders, str):
-            indexFolders = [indexFolders]
-        if indexFileName:
-            # A given index file name takes precedence and there should be no implicit fallback
-            possibleIndexFilePaths = [os.path.abspath(os.path.expanduser(indexFileName))]
-        elif indexFolders:
-            # An empty path is to be interpreted as the default path right besides the TAR
-            if '' not in indexFolders:
-                possibleIndexFilePaths = []
-            for folder in indexFolders:
-                if folder:
-                    indexPath = os.path.join(folder, indexPathAsName)
-                    possibleIndexFilePaths.append(os.path.abspath(os.path.expanduser(indexPath)))
+    def _chunkPath(self, index: int) -> str:
+        return os.path.join(typing.cast(str, self.chunkFolder), str(index))
 
-        self.indexFileName = None
-        if clearIndexCache:
-            for indexPath in possibleIndexFilePaths:
-                if os.path.isfile(indexPath):
-                    os.remove(indexPath)
+    def _loadChunk(self, index: int) -> Optional[bytes]:
+        chunk = self.memoryCache.get(index)
+        if chunk is None and self.chunkFolder:
+            try:
+                with open(self._chunkPath(index), 'rb') as file:
+                    chunk = file.read()
+                # The modification time marks the last use for the eviction because atime is often not updated.
+                os.utime(self._chunkPath(index))
+                self.memoryCache.insert(index, chunk)
+            except OSError:
+                pass
+        return chunk
 
-        # Try to find an already existing index
-        for indexPath in possibleIndexFilePaths:
-            if self._tryLoadIndex(indexPath):
-                self.indexFileName = indexPath
-                break
-        if self.indexIsLoaded():
-            self._loadOrStoreCompressionOffsets()
+    def _storeChunk(self, index: int, chunk: bytes) -> None:
+        self.memoryCache.insert(index, chunk)
+        if not self.chunkFolder or not self.persistChunks:
+            return
+        try:
+            # Write to a temporary file first, so that concurrent readers never see partially written chunks.
+            os.makedirs(self.chunkFolder, exist_ok=True)
+            with tempfile.NamedTemporaryFile(dir=self.chunkFolder, delete=False) as file:
+                file.write(chunk)
+            os.replace(file.name, self._chunkPath(index))
+        except OSError as exception:
+            if printDebug >= 2:
+                print("[Info] Could not store the remote chunk in the cache because of:", exception)
             return
 
-        # Find a suitable (writable) location for the index database
-        if writeIndex:
-            for indexPath in possibleIndexFilePaths:
-                if self._pathIsWritable(indexPath) and self._pathCanBeUsedForSqlite(indexPath):
-                    self.indexFileName = indexPath
+        with RemoteFile._cacheLock:
+            if RemoteFile._cacheUsage is None:
+                RemoteFile._cacheUsage = sum(size for _, size, _ in RemoteFile._listCachedChunks())
+            else:
+                RemoteFile._cacheUsage += len(chunk)
+            if RemoteFile._cacheUsage > RemoteFile.cacheSize:
+                RemoteFile._evictChunks()
+
+    @staticmethod
+    def _listCachedChunks() -> List[Tuple[float, int, str]]:
+        """Returns the modification time, size, and path of all chunks in the on-disk cache."""
+        chunks = []
+        for folder, _, files in os.walk(RemoteFile._chunksFolder()):
+            for name in files:
+                try:
+                    stats = os.stat(os.path.join(folder, name))
+                    chunks.append((stats.st_mtime, stats.st_size, os.path.join(folder, name)))
+                except OSError:
+                    pass
+        return chunks
+
+    @staticmethod
+    def _evictChunks() -> None:
+        """
+        Deletes the least recently used chunks until the on-disk cache only uses three quarters of cacheSize,
+        so that not every newly stored chunk requires another eviction. Must be called with _cacheLock.
+        """
+        chunks = sorted(RemoteFile._listCachedChunks())
+        usage = sum(size for _, size, _ in chunks)
+        for _, size, path in chunks:
+            if usage <= RemoteFile.cacheSize * 3 // 4:
+                break
+            try:
+                os.remove(path)
+                usage -= size
+            except OSError:
+                pass
+        RemoteFile._cacheUsage = usage
+
+    def _fetchChunks(self, first: int, last: int) -> List[bytes]:
+        """Fetches the chunks from first to last inclusively with one request and stores them in the cache."""
+        begin = first * self.chunkSize
+        end = min(self.fileSize, (last + 1) * self.chunkSize)
+        data = RemoteFile._requestUnchanged(self.url, begin, end - 1, self.fileSize, self.etag)
+
+        performanceStatistics.count('remote.requests')
+        performanceStatistics.count('remote.bytesFetched', len(data))
+        chunks = [data[offset : offset + self.chunkSize] for offset in range(0, len(data), self.chunkSize)]
+        for index, chunk in enumerate(chunks, first):
+            self._storeChunk(index, chunk)
+        return chunks
+
+    def _getChunks(self, first: int, last: int) -> List[bytes]:
+        """Returns the chunks from first to last inclusively and fetches all missing ones with as few requests
+        as possible."""
+        chunks: Dict[int, bytes] = {}
+        missing = []
+        for index in range(first, last + 1):
+            chunk = self._loadChunk(index)
+            if chunk is None:
+                missing.append(index)
+            else:
+                chunks[index] = chunk
+
+        if missing:
+            # Fetch more and more chunks ahead on sequential access in order to reduce the number of requests.
+            # Without the on-disk cache, the chunks read ahead must fit into the memory cache until they are read.
+            maxReadAhead = self.memoryCache.maxSize // self.chunkSize // 2
+            if self.chunkFolder and self.persistChunks:
+                maxReadAhead = self.maxReadAhead
+            self.readAhead = min(2 * self.readAhead + 1, maxReadAhead) if missing[0] == self.lastFetched + 1 else 0
+            lastChunk = max(0, (self.fileSize - 1) // self.chunkSize)
+            while missing[-1] < lastChunk and missing[-1] < last + self.readAhead and missing[-1] + 1 not in chunks:
+                if self._loadChunk(missing[-1] + 1) is not None:
                     break
+                missing.append(missing[-1] + 1)
 
-        if not self.indexFileName:
-            raise InvalidIndexError(
-                "Could not find any existing index or writable location for an index in " + str(possibleIndexFilePaths)
-            )
+            # Coalesce consecutive missing chunks into one request.
+            runStart = 0
+            for i in range(1, len(missing) + 1):
+                if i == len(missing) or missing[i] != missing[i - 1] + 1:
+                    fetched = self._fetchChunks(missing[runStart], missing[i - 1])
+                    chunks.update(zip(range(missing[runStart], missing[i - 1] + 1), fetched))
+                    runStart = i
+            self.lastFetched = missing[-1]
 
-        self._createIndex(self.tarFileObject)
-        self._loadOrStoreCompressionOffsets()  # store
-        if self.sqlConnection:
-            self._storeMetadata(self.sqlConnection)
+        return [chunks[index] for index in range(first, last + 1)]
 
-        if printDebug >= 1 and writeIndex:
-            # The 0-time is legacy for the automated tests
-            # fmt: off
-            print("Writing out TAR index to", self.indexFileName, "took 0s",
+    @overrides(io.BufferedIOBase)
+    def fileno(self) -> int:
+        raise io.UnsupportedOperation("Remote files have no file descriptor!")
+
+    @overrides(io.BufferedIOBase)
+    def seekable(self) -> bool:
+        return True
+
+    @overrides(io.BufferedIOBase)
+    def readable(self) -> bool:
+        return True
+
+    @overrides(io.BufferedIOBase)
+    def writable(self) -> bool:
+        return False
+
+    @overrides(io.BufferedIOBase)
+    def read(self, size: int = -1) -> bytes:
+        with self.lock:
+            end = self.fileSize if size is None or size < 0 else min(self.fileSize, self.offset + size)
+            if end <= self.offset:
+                return b''
+
+            first = self.offset // self.chunkSize
+            data = b''.join(self._getChunks(first, (end - 1) // self.chunkSize))
+            offsetInData = self.offset - first * self.chunkSize
+            result = data[offsetInData : offsetInData + end - self.offset]
+            self.offset += len(result)
+            return result
+
+    @overrides(io.BufferedIOBase)
+    def seek(self, offset: int, whence: int = io.SEEK_SET) -> int:
+        if whence == io.SEEK_CUR:
+            offset += self.offset
+        elif whence == io.SEEK_END:
+            offset += self.fileSize
+        if offset < 0:
+            raise ValueError("Trying to seek before the start of the file!")
+        self.offset = offset
+        return self.offset
+
+    @overrides(io.BufferedIOBase)
+    def tell(self) -> int:
+        return self.offset
+
+
+def _readZstdSeekTable(fileobj: IO[bytes]) -> Optional[Dict[int, int]]:
+    """
+    Returns the frame offsets stored in the seek table of a zstd file in the seekable format, see
+    https://github.com/facebook/zstd/blob/dev/contrib/seekable_format/zstd_seekable_compression_format.md
+    or None if there is no seek table. The returned dictionary maps the compressed offsets of the frames to
+    the decompressed offsets like IndexedZstdFile.block_offsets and also contains the offsets of the end.
+    """
+    fileSize = fileobj.seek(0, io.SEEK_END)
+    if fileSize < 9 + 8:
+        return None
+
+    fileobj.seek(fileSize - 9)
+    frameCount, descriptor, magic = struct.unpack('<IBI', fileobj.read(9))
+    if magic != 0x8F92EAB1 or descriptor & 0x7C:
+        return None
+
+    entrySize = 12 if descriptor & 0x80 else 8
+    seekTableSize = 8 + frameCount * entrySize + 9
+    if seekTableSize > fileSize:
+        return None
+
+    fileobj.seek(fileSize - seekTableSize)
+    entries = fileobj.read(seekTableSize - 9)
+    if struct.unpack('<II', entries[:8]) != (0x184D2A5E, seekTableSize - 8):
+        return None
+
+    offsets = {}
+    compressedOffset = 0
+    decompressedOffset = 0
+    for i in range(frameCount):
+        compressedSize, decompressedSize = struct.unpack_from('<II', entries, 8 + i * entrySize)
+        offsets[compressedOffset] = decompressedOffset
+        compressedOffset += compressedSize
+        decompressedOffset += decompressedSize
+    offsets[compressedOffset] = decompressedOffset
+
+    return offsets if compressedOffset == fileSize - seekTableSize else None
+
+
+def _scanZstdFrames(fileobj: IO[bytes], maxFrameSize: Optional[int] = None) -> Optional[Dict[int, int]]:
+    """
+    Returns the frame offsets of a zstd file by only parsing the frame and block headers like _readZstdSeekTable.
+    This works for files with multiple independently compressed frames, e.g., created by pzstd. Returns None if
+    a frame does not store its decompressed size because it then has to be decompressed in order to find it out.
+    Also returns None as soon as a frame larger than maxFrameSize is found. This avoids skipping over all blocks
+    of files consisting of only one large frame.
+    """
+    offsets = {}
+    compressedOffset = 0
+    decompressedOffset = 0
+    fileSize = fileobj.seek(0, io.SEEK_END)
+
+    while compressedOffset < fileSize:
+        fileobj.seek(compressedOffset)
+        header = fileobj.read(8)
+        if len(header) < 8:
+            return None
+        magic, frameSize = struct.unpack('<II', header)
+
+        # Skip skippable frames, which are, e.g., used by pzstd to store the size of the next frame.
+        if magic & 0xFFFFFFF0 == 0x184D2A50:
+            compressedOffset += 8 + frameSize
+            continue
+        if magic != 0xFD2FB528:
+            return None
+
+        descriptor = header[4]
+        fcsFlag = descriptor >> 6
+        singleSegment = (descriptor >> 5) & 1
+        fcsSize = [singleSegment, 2, 4, 8][fcsFlag]
+        if fcsSize == 0:
+            return None
+
+        headerSize = 4 + 1 + (1 - singleSegment) + [0, 1, 2, 4][descriptor & 3]
+        fileobj.seek(compressedOffset + headerSize)
+        contentSize = int.from_bytes(fileobj.read(fcsSize), 'little') + (256 if fcsSize == 2 else 0)
+        if maxFrameSize is not None and contentSize > maxFrameSize:
+            return None
+
+        # Skip over all blocks without decompressing them.
+        blockOffset = compressedOffset + headerSize + fcsSize
+        while True:
+            fileobj.seek(blockOffset)
+            blockHeaderBytes = fileobj.read(3)
+            if len(blockHeaderBytes) < 3:
+                return None
+            blockHeader = int.from_bytes(blockHeaderBytes, 'little')
+            blockType = (blockHeader >> 1) & 3
+            blockOffset += 3 + (1 if blockType == 1 else blockHeader >> 3)
+            if blockHeader & 1:
+                break
+
+        offsets[compressedOffset] = decompressedOffset
+        compressedOffset = blockOffset + (4 if descriptor & 0x04 else 0)
+        decompressedOffset += contentSize
+
+    if compressedOffset != fileSize:
+        return None
+
+    offsets[compressedOffset] = decompressedOffset
+    return offsets
+
+
+def findZstdFrameOffsets(fileobj: IO[bytes], maxFrameSize: Optional[int] = None) -> Optional[Dict[int, int]]:
+    """
+    Returns the frame offsets of a zstd file in the format of IndexedZstdFile.block_offsets
+    without decompressing it or None if they can't be determined this way. See _scanZstdFrames for maxFrameSize.
+    """
+    oldOffset = fileobj.tell()
+    try:
+        offsets = _readZstdSeekTable(fileobj)
+        return offsets if offsets else _scanZstdFrames(fileobj, maxFrameSize)
+    except (OSError, ValueError, struct.error):
+        return None
+    finally:
+        fileobj.seek(oldOffset)
+
+
+class ParallelBlockFile(io.BufferedIOBase):
+    """
+    A seekable view of a compressed file consisting of independently compressed blocks with known offsets.
+    The blocks are decoded on a thread pool. On sequential access, e.g., when creating the index, the blocks
+    following the currently read one are decoded ahead of time. Derived classes implement _decodeBlock.
+    The block offset interface mimics IndexedBzip2File and IndexedZstdFile, so that the offsets can be stored
+    in the index.
+    """
+
+    # Files with larger blocks should be decoded serially because each block is decoded into memory as a whole.
+    maxBlockSize = 64 * 1024 * 1024
+
+    def __init__(self, fileobj: IO[bytes], blockOffsets: Dict[int, int], parallelization: int) -> None:
+        """
+        fileobj : The compressed file, which is not closed by this object.
+        blockOffsets : Maps the compressed offset of each block to its decompressed offset and must contain
+                       the offsets of the end of the file.
+        """
+        # fmt: off
+        self.fileobj         = fileobj
+        self.fileobjLock     = threading.Lock()
+        self.parallelization = parallelization
+        self.executor        = concurrent.futures.ThreadPoolExecutor(max_workers=parallelization)
+        self.blocks: Dict[int, concurrent.futures.Future] = {}
+        self.lastBlock       = -1
+        self.offset          = 0
+        self.compressedOffsets: List[int] = []
+        self.decompressedOffsets: List[int] = []
+        # fmt: on
+        self.set_block_offsets(blockOffsets)
+
+    @staticmethod
+    def hasSuitableBlocks(blockSizes: List[int]) -> bool:
+        """Returns true if there is more than one block and all decompressed sizes are small enough for this class."""
+        return len(blockSizes) > 1 and max(blockSizes) <= ParallelBlockFile.maxBlockSize
+
+    def set_block_offsets(self, offsets: Dict[int, int]) -> None:
+        for future in self.blocks.values():
+            future.cancel()
+        self.blocks = {}
+        self.compressedOffsets = sorted(offsets.keys())
+        self.decompressedOffsets = [offsets[offset] for offset in self.compressedOffsets]
+
+    def block_offsets(self) -> Dict[int, int]:
+        return dict(zip(self.compressedOffsets, self.decompressedOffsets))
+
+    def size(self) -> int:
+        return self.decompressedOffsets[-1] if self.decompressedOffsets else 0
+
+    def _decodeBlock(self, index: int, compressedData: bytes, size: int) -> bytes:
+        """Returns at most size decoded bytes of the index-th block given its compressed data."""
+        raise NotImplementedError
+
+    def _readBlock(self, index: int) -> bytes:
+        with self.fileobjLock:
+            self.fileobj.seek(self.compressedOffsets[index])
+            compressedData = self.fileobj.read(self.compressedOffsets[index + 1] - self.compressedOffsets[index])
+
+        size = self.decompressedOffsets[index + 1] - self.decompressedOffsets[index]
+        block = self._decodeBlock(index, compressedData, size)
+        if len(block) != size:
+            raise CompressionError(
+                "Block {} at offset {} decoded to {} B instead of {} B!".format(
+                    index, self.compressedOffsets[index], len(block), size
+                )
+            )
+        return block
+
+    def _getBlock(self, index: int) -> bytes:
+        # Only decode ahead on sequential access in order to not waste work on random accesses.
+        lastBlock = index + self.parallelization if index in (self.lastBlock, self.lastBlock + 1) else index
+        lastBlock = min(lastBlock, len(self.compressedOffsets) - 2)
+        self.lastBlock = index
+
+        for i in [i for i in self.blocks if i < index or i > lastBlock]:
+            self.blocks.pop(i).cancel()
+        for i in range(index, lastBlock + 1):
+            if i not in self.blocks:
+                self.blocks[i] = self.executor.submit(self._readBlock, i)
+        return self.blocks[index].result()
+
+    @overrides(io.BufferedIOBase)
+    def close(self) -> None:
+        # Don't close the object given to us
+        for future in self.blocks.values():
+            future.cancel()
+        self.blocks = {}
+        self.executor.shutdown(wait=False)
+        super().close()
+
+    @overrides(io.BufferedIOBase)
+    def fileno(self) -> int:
+        return self.fileobj.fileno()
+
+    @overrides(io.BufferedIOBase)
+    def seekable(self) -> bool:
+        return True
+
+    @overrides(io.BufferedIOBase)
+    def readable(self) -> bool:
+        return True
+
+    @overrides(io.BufferedIOBase)
+    def writable(self) -> bool:
+        return False
+
+    @overrides(io.BufferedIOBase)
+    def read(self, size: int = -1) -> bytes:
+        result = []
+        while size != 0 and self.offset < self.size():
+            index = bisect.bisect_right(self.decompressedOffsets, self.offset) - 1
+            block = self._getBlock(index)
+            offsetInBlock = self.offset - self.decompressedOffsets[index]
+            chunk = block[offsetInBlock:] if size < 0 else block[offsetInBlock : offsetInBlock + size]
+            if not chunk:
+                break
+
+            result.append(chunk)
+            self.offset += len(chunk)
+            if size > 0:
+                size -= len(chunk)
+
+        return result[0] if len(result) == 1 else b''.join(result)
+
+    @overrides(io.BufferedIOBase)
+    def seek(self, offset: int, whence: int = io.SEEK_SET) -> int:
+        if whence == io.SEEK_CUR:
+            offset += self.offset
+        elif whence == io.SEEK_END:
+            offset += self.size()
+        if offset < 0:
+            raise ValueError("Trying to seek before the start of the file!")
+        self.offset = offset
+        return self.offset
+
+    @overrides(io.BufferedIOBase)
+    def tell(self) -> int:
+        return self.offset
+
+
+class ParallelZstdFile(ParallelBlockFile):
+    """Decodes the independent frames of a zstd file, see findZstdFrameOffsets, in parallel with IndexedZstdFile."""
+
+    @overrides(ParallelBlockFile)
+    def _decodeBlock(self, index: int, compressedData: bytes, size: int) -> bytes:
+        return indexed_zstd.IndexedZstdFile(io.BytesIO(compressedData)).read(size)
+
+
+def _readXzVarint(data: bytes, offset: int) -> Tuple[int, int]:
+    """Returns the variable-length integer of the xz format starting at offset and the offset after it."""
+    value = 0
+    for i in range(9):
+        byte = data[offset + i]
+        value |= (byte & 0x7F) << (7 * i)
+        if not byte & 0x80:
+            return value, offset + i + 1
+    raise ValueError("Invalid variable-length integer in xz index!")
+
+
+# offset and size of the block in the compressed file including the padding and the header of its stream
+XzBlock = collections.namedtuple("XzBlock", "offset size uncompressedsize streamheader")
+
+
+def readXzBlocks(fileobj: IO[bytes]) -> List[XzBlock]:
+    """
+    Returns all blocks of an xz file in order by only reading the indexes stored at the end of each stream,
+    see https://tukaani.org/xz/xz-file-format.txt. Raises a ValueError if the file is not a valid xz file.
+    """
+    blocks: List[XzBlock] = []
+    streamEnd = fileobj.seek(0, io.SEEK_END)
+
+    # Walk the concatenated streams from the last to the first one.
+    while streamEnd > 0:
+        fileobj.seek(streamEnd - 4)
+        if fileobj.read(4) == b'\x00' * 4:
+            streamEnd -= 4  # stream padding
+            continue
+
+        fileobj.seek(max(0, streamEnd - 12))
+        footer = fileobj.read(12)
+        if len(footer) < 12 or footer[10:12] != b'YZ' or zlib.crc32(footer[4:10]) != struct.unpack('<I', footer[:4])[0]:
+            raise ValueError("Invalid xz stream footer!")
+
+        indexSize = (struct.unpack('<I', footer[4:8])[0] + 1) * 4
+        indexOffset = streamEnd - 12 - indexSize
+        fileobj.seek(max(0, indexOffset))
+        index = fileobj.read(indexSize)
+        if indexOffset < 12 or index[0] != 0 or zlib.crc32(index[:-4]) != struct.unpack('<I', index[-4:])[0]:
+            raise ValueError("Invalid xz index!")
+
+        records = []
+        recordCount, position = _readXzVarint(index, 1)
+        for _ in range(recordCount):
+            unpaddedSize, position = _readXzVarint(index, position)
+            uncompressedSize, position = _readXzVarint(index, position)
+            records.append(((unpaddedSize + 3) // 4 * 4, uncompressedSize))
+
+        streamOffset = indexOffset - sum(size for size, _ in records) - 12
+        fileobj.seek(max(0, streamOffset))
+        header = fileobj.read(12)
+        if streamOffset < 0 or header[:6] != b"\xFD7zXZ\x00" or header[6:8] != footer[8:10]:
+            raise ValueError("Invalid xz stream header!")
+
+        streamBlocks = []
+        blockOffset = streamOffset + len(header)
+        for size, uncompressedSize in records:
+            streamBlocks.append(XzBlock(blockOffset, size, uncompressedSize, header))
+            blockOffset += size
+        blocks = streamBlocks + blocks
+        streamEnd = streamOffset
+
+    return blocks
+
+
+class ParallelXzFile(ParallelBlockFile):
+    """
+    Decodes the blocks of an xz file in parallel with the lzma module. The block offsets are read from the indexes
+    stored in the xz file itself when opening it, see readXzBlocks, so that seeking is possible right away.
+    """
+
+    def __init__(self, fileobj: IO[bytes], blocks: List[XzBlock], parallelization: int) -> None:
+        blockOffsets = {}
+        decompressedOffset = 0
+        for block in blocks:
+            blockOffsets[block.offset] = decompressedOffset
+            decompressedOffset += block.uncompressedsize
+        if blocks:
+            blockOffsets[blocks[-1].offset + blocks[-1].size] = decompressedOffset
+
+        self.xzBlocks = {block.offset: block for block in blocks}
+        super().__init__(fileobj, blockOffsets, parallelization)
+
+    @property
+    def block_boundaries(self) -> List[int]:
+        """The decompressed offsets of all blocks like for lzmaffi."""
+        return self.decompressedOffsets[:-1]
+
+    @overrides(ParallelBlockFile)
+    def _decodeBlock(self, index: int, compressedData: bytes, size: int) -> bytes:
+        block = self.xzBlocks.get(self.compressedOffsets[index])
+        if block is None:
+            raise CompressionError("Offset {} is not the start of an xz block!".format(self.compressedOffsets[index]))
+
+        # The last block of a stream is followed by the index, which must not be decoded because it would not
+        # match the single block the decoder has seen. Without the index, the decoder simply waits for more input.
+        decompressor = lzma.LZMADecompressor(format=lzma.FORMAT_XZ)
+        return decompressor.decompress(block.streamheader + compressedData[: block.size])
+
+
+def openXzFile(fileobj: IO[bytes], parallelization: int = 1) -> Any:
+    """
+    Opens ParallelXzFile if the xz file consists of multiple blocks, which are small enough to be decoded
+    into memory one at a time. Else, a decoder, which decodes the whole file serially, is returned.
+    """
+    try:
+        blocks = readXzBlocks(fileobj)
+        if ParallelBlockFile.hasSuitableBlocks([block.uncompressedsize for block in blocks]):
+            return ParallelXzFile(fileobj, blocks, parallelization)
+    except (OSError, ValueError, IndexError):
+        pass
+
+    fileobj.seek(0)
+    return lzmaffi.open(fileobj) if 'lzmaffi' in globals() else lzma.open(fileobj)
+
+
+class ScannedTarInfo:
+    """The subset of tarfile.TarInfo returned by TarHeaderScanner, which is used for creating the index."""
+
+    __slots__ = ('name', 'offset', 'offset_data', 'size', 'mtime', 'mode', 'type', 'linkname', 'uid', 'gid')
+
+    # fmt: off
+    def isfile  (self) -> bool: return self.type in tarfile.REGULAR_TYPES
+    def isreg   (self) -> bool: return self.type in tarfile.REGULAR_TYPES
+    def isdir   (self) -> bool: return self.type == tarfile.DIRTYPE
+    def issym   (self) -> bool: return self.type == tarfile.SYMTYPE
+    def ischr   (self) -> bool: return self.type == tarfile.CHRTYPE
+    def isfifo  (self) -> bool: return self.type == tarfile.FIFOTYPE
+    def issparse(self) -> bool: return False
+    # fmt: on
+
+
+class TarHeaderScanner:
+    """
+    A faster replacement for iterating over an uncompressed, seekable TAR with tarfile in 'r:' mode. It only parses
+    the header fields needed for the index directly from each 512 B header block instead of constructing full
+    TarInfo objects. Ustar, GNU long names and links, and PAX extended headers are supported. When the first GNU
+    sparse file, PAX global header, or other rarely used feature is encountered, it falls back to tarfile for the
+    rest of the archive, which then yields tarfile.TarInfo objects instead of ScannedTarInfo.
+
+    It behaves like tarfile, i.e., it raises tarfile.ReadError on construction if the first header is invalid.
+
+    For decompressor file objects, streaming should be true. Then, the file object is only seeked forward and its
+    size is not queried beforehand, so that the file contents are skipped by the decompressor in one pass.
+    """
+
+    BLOCKSIZE = tarfile.BLOCKSIZE
+    _paxRecordRegex = re.compile(br"(\d+) ([^=]+)=")
+
+    class _UnsupportedFeature(Exception):
+        pass
+
+    def __init__(
+        # fmt: off
+        self,
+        fileObject : IO[bytes],
+        encoding   : str  = tarfile.ENCODING,
+        ignoreZeros: bool = False,
+        streaming  : bool = False,
+        # fmt: on
+    ) -> None:
+        # fmt: off
+        self.fileObject  = fileObject
+        self.encoding    = encoding
+        self.errors      = 'surrogateescape'
+        self.ignoreZeros = ignoreZeros
+        self.offset      = fileObject.tell()
+        self.fileSize    = None if streaming else fileObject.seek(0, io.SEEK_END)
+        self.tarFile: Optional[tarfile.TarFile] = None
+        # Only for compatibility with the tarfile interface because _createIndex clears this.
+        self.members: List[Any] = []
+        # fmt: on
+
+        self.firstMember = self._next()
+
+    def __iter__(self) -> Iterator[Any]:
+        member = self.firstMember
+        self.firstMember = None
+        while member is not None:
+            yield member
+            member = self._next()
+
+    def extractfile(self, member: Any) -> IO[bytes]:
+        return typing.cast(IO[bytes], StenciledFile(self.fileObject, [(member.offset_data, member.size)]))
+
+    def tell(self) -> int:
+        """Returns the offset after the last returned member, at which the next header is expected."""
+        return self.tarFile.offset if self.tarFile else self.offset
+
+    @staticmethod
+    def _block(size: int) -> int:
+        return (size + TarHeaderScanner.BLOCKSIZE - 1) // TarHeaderScanner.BLOCKSIZE * TarHeaderScanner.BLOCKSIZE
+
+    @staticmethod
+    def _nti(field: bytes) -> int:
+        if field and field[0] in (0o200, 0o377):
+            return tarfile.nti(field)
+        try:
+            return int(field.split(b'\0', 1)[0].strip() or b'0', 8)
+        except ValueError:
+            raise tarfile.InvalidHeaderError("invalid header") from None
+
+    def _nts(self, field: bytes) -> str:
+        return field.split(b'\0', 1)[0].decode(self.encoding, self.errors)
+
+    def _readHeader(self) -> Any:
+        """Parses the header block at the current position like tarfile.TarInfo.frombuf but without PAX or GNU
+        extensions processed."""
+        buffer = self.fileObject.read(self.BLOCKSIZE)
+        if len(buffer) == 0:
+            raise tarfile.EmptyHeaderError("empty header")
+        if len(buffer) != self.BLOCKSIZE:
+            raise tarfile.TruncatedHeaderError("truncated header")
+        if buffer.count(0) == self.BLOCKSIZE:
+            raise tarfile.EOFHeaderError("end of file header")
+
+        checksum = self._nti(buffer[148:156])
+        if checksum != sum(buffer[:148]) + sum(buffer[156:]) + 256 and checksum not in tarfile.calc_chksums(buffer):
+            raise tarfile.InvalidHeaderError("bad checksum")
+
+        tarInfo = ScannedTarInfo()
+        # fmt: off
+        tarInfo.name     = self._nts(buffer[0:100])
+        tarInfo.mode     = self._nti(buffer[100:108])
+        tarInfo.uid      = self._nti(buffer[108:116])
+        tarInfo.gid      = self._nti(buffer[116:124])
+        tarInfo.size     = self._nti(buffer[124:136])
+        tarInfo.mtime    = self._nti(buffer[136:148])
+        tarInfo.type     = buffer[156:157]
+        tarInfo.linkname = self._nts(buffer[157:257])
+        # fmt: on
+        # Only checked for validity like tarfile does.
+        self._nti(buffer[329:337])
+        self._nti(buffer[337:345])
+        prefix = self._nts(buffer[345:500])
+
+        # Old V7 tar format represents a directory as a regular file with a trailing slash.
+        if tarInfo.type == tarfile.AREGTYPE and tarInfo.name.endswith('/'):
+            tarInfo.type = tarfile.DIRTYPE
+        if tarInfo.type == tarfile.DIRTYPE:
+            tarInfo.name = tarInfo.name.rstrip('/')
+        if prefix and tarInfo.type not in tarfile.GNU_TYPES:
+            tarInfo.name = prefix + '/' + tarInfo.name
+
+        tarInfo.offset = self.fileObject.tell() - self.BLOCKSIZE
+        tarInfo.offset_data = tarInfo.offset + self.BLOCKSIZE
+        return tarInfo
+
+    def _decodePaxField(self, value: bytes, encoding: str, fallbackEncoding: str) -> str:
+        try:
+            return value.decode(encoding, 'strict')
+        except UnicodeDecodeError:
+            return value.decode(fallbackEncoding, self.errors)
+
+    def _readMember(self) -> Any:
+        """Reads the next member including all preceding GNU long name and PAX extended headers."""
+        tarInfo = self._readHeader()
+        firstOffset = tarInfo.offset
+        # Overrides in the order they were encountered. Like tarfile, the first one is applied last.
+        overrides: List[Tuple[bytes, Any]] = []
+
+        while tarInfo.type in (tarfile.GNUTYPE_LONGNAME, tarfile.GNUTYPE_LONGLINK, tarfile.XHDTYPE, b'X'):
+            buffer = self.fileObject.read(self._block(tarInfo.size))
+            if tarInfo.type in (tarfile.GNUTYPE_LONGNAME, tarfile.GNUTYPE_LONGLINK):
+                overrides.append((tarInfo.type, self._nts(buffer)))
+            else:
+                overrides.append((tarfile.XHDTYPE, self._parsePaxHeader(buffer)))
+
+            try:
+                tarInfo = self._readHeader()
+            except tarfile.HeaderError as exception:
+                raise tarfile.ReadError(str(exception)) from None
+
+        if tarInfo.type in (tarfile.GNUTYPE_SPARSE, tarfile.XGLTYPE):
+            raise TarHeaderScanner._UnsupportedFeature()
+
+        for overrideType, value in reversed(overrides):
+            if overrideType == tarfile.GNUTYPE_LONGNAME:
+                tarInfo.name = value
+                if tarInfo.type == tarfile.DIRTYPE:
+                    tarInfo.name = tarInfo.name[:-1] if tarInfo.name.endswith('/') else tarInfo.name
+            elif overrideType == tarfile.GNUTYPE_LONGLINK:
+                tarInfo.linkname = value
+            else:
+                # fmt: off
+                if 'path'     in value: tarInfo.name     = value['path']
+                if 'linkpath' in value: tarInfo.linkname = value['linkpath']
+                if 'size'     in value: tarInfo.size     = value['size']
+                if 'mtime'    in value: tarInfo.mtime    = value['mtime']
+                if 'uid'      in value: tarInfo.uid      = value['uid']
+                if 'gid'      in value: tarInfo.gid      = value['gid']
+                # fmt: on
+        tarInfo.offset = firstOffset
+
+        if tarInfo.isreg() or tarInfo.type not in tarfile.SUPPORTED_TYPES:
+            self.offset = tarInfo.offset_data + self._block(tarInfo.size)
+        else:
+            self.offset = tarInfo.offset_data
+        return tarInfo
+
+    def _parsePaxHeader(self, buffer: bytes) -> Dict[str, Any]:
+        values: Dict[str, Any] = {}
+        position = 0
+        while True:
+            match = self._paxRecordRegex.match(buffer, position)
+            if not match:
+                break
+            length = int(match.group(1))
+            if length == 0:
+                raise tarfile.InvalidHeaderError("invalid header")
+            keyword = self._decodePaxField(match.group(2), 'utf-8', 'utf-8')
+            value = buffer[match.end(2) + 1 : match.start(1) + length - 1]
+            if keyword.startswith('GNU.sparse') or keyword == 'hdrcharset':
+                raise TarHeaderScanner._UnsupportedFeature()
+
+            if keyword in tarfile.PAX_NAME_FIELDS:
+                values[keyword] = self._decodePaxField(value, 'utf-8', self.encoding)
+            else:
+                values[keyword] = self._decodePaxField(value, 'utf-8', 'utf-8')
+            if keyword in tarfile.PAX_NUMBER_FIELDS:
+                try:
+                    values[keyword] = tarfile.PAX_NUMBER_FIELDS[keyword](values[keyword])
+                except ValueError:
+                    values[keyword] = 0
+            if keyword == 'path':
+                values[keyword] = values[keyword].rstrip('/')
+            position += length
+        return values
+
+    def _next(self) -> Any:
+        """Returns the next member like tarfile.TarFile.next does, including its error behavior."""
+        if self.tarFile:
+            return self.tarFile.next()
+
+        # Reading past the end of the file would indicate a truncated TAR, which tarfile detects like this.
+        if self.offset != self.fileObject.tell():
+            if self.fileSize is None:
+                # Like tarfile, check that the byte before the next header exists without knowing the file size.
+                self.fileObject.seek(self.offset - 1)
+                if not self.fileObject.read(1):
+                    raise tarfile.ReadError("unexpected end of data")
+            elif self.offset > self.fileSize:
+                raise tarfile.ReadError("unexpected end of data")
+            self.fileObject.seek(self.offset)
+
+        while True:
+            try:
+                return self._readMember()
+            except TarHeaderScanner._UnsupportedFeature:
+                self.fileObject.seek(self.offset)
+                self.tarFile = tarfile.open(
+                    # fmt:off
+                    fileobj      = self.fileObject,
+                    mode         = 'r:',
+                    ignore_zeros = self.ignoreZeros,
+                    encoding     = self.encoding,
+                    # fmt:on
+                )
+                return self.tarFile.next()
+            except (tarfile.EOFHeaderError, tarfile.InvalidHeaderError) as exception:
+                if self.ignoreZeros:
+                    self.offset += self.BLOCKSIZE
+                    self.fileObject.seek(self.offset)
+                    continue
+                if isinstance(exception, tarfile.InvalidHeaderError) and self.offset == 0:
+                    raise tarfile.ReadError(str(exception)) from None
+            except tarfile.EmptyHeaderError:
+                if self.offset == 0:
+                    raise tarfile.ReadError("empty file") from None
+            except tarfile.TruncatedHeaderError as exception:
+                if self.offset == 0:
+                    raise tarfile.ReadError(str(exception)) from None
+            return None
+
+
+class SQLiteBlobsFile(io.RawIOBase):
+    """
+    A read-only file object streaming the concatenation of all blobs in a table column in the order of insertion.
+    Only one blob is held in memory at a time. See SQLiteBlobsWriter.
+    """
+
+    def __init__(self, connection: sqlite3.Connection, table: str, column: str) -> None:
+        # fmt: off
+        self.rows   = connection.execute('SELECT "{}" FROM "{}" ORDER BY rowid;'.format(column, table))
+        self.buffer = memoryview(b'')
+        self.offset = 0
+        # fmt: on
+
+    @overrides(io.RawIOBase)
+    def readable(self) -> bool:
+        return True
+
+    @overrides(io.RawIOBase)
+    def readinto(self, buffer) -> int:
+        # Fill the whole buffer if possible because callers like indexed_gzip might not expect short reads.
+        buffer = memoryview(buffer).cast('B')
+        written = 0
+        while written < len(buffer):
+            if not self.buffer:
+                row = self.rows.fetchone()
+                if row is None:
+                    break
+                self.buffer = memoryview(row[0])
+                continue
+
+            size = min(len(buffer) - written, len(self.buffer))
+            buffer[written : written + size] = self.buffer[:size]
+            self.buffer = self.buffer[size:]
+            written += size
+
+        self.offset += written
+        return written
+
+    @overrides(io.RawIOBase)
+    def tell(self) -> int:
+        return self.offset
+
+
+class SQLiteBlobsWriter(io.RawIOBase):
+    """
+    A write-only file object, which stores the written data as consecutive blobs of chunkSize into a table column.
+    This avoids having to hold all of the data in memory or in a temporary file.
+    The last chunk is only inserted on close, which is also done when used as a context manager.
+    """
+
+    def __init__(
+        self, connection: sqlite3.Connection, table: str, column: str, chunkSize: int = 16 * 1024 * 1024
+    ) -> None:
+        # fmt: off
+        self.connection = connection
+        self.insertSql  = 'INSERT INTO "{}" ("{}") VALUES (?);'.format(table, column)
+        self.chunkSize  = chunkSize
+        self.buffer     = bytearray()
+        self.offset     = 0
+        # fmt: on
+
+    def _insert(self, chunk) -> None:
+        self.connection.execute(self.insertSql, (chunk,))
+
+    @overrides(io.RawIOBase)
+    def writable(self) -> bool:
+        return True
+
+    @overrides(io.RawIOBase)
+    def write(self, data) -> int:
+        self.buffer += data
+        self.offset += len(data)
+        while len(self.buffer) >= self.chunkSize:
+            self._insert(bytes(self.buffer[: self.chunkSize]))
+            del self.buffer[: self.chunkSize]
+        return len(data)
+
+    @overrides(io.RawIOBase)
+    def tell(self) -> int:
+        return self.offset
+
+    @overrides(io.RawIOBase)
+    def close(self) -> None:
+        if not self.closed and self.buffer:
+            self._insert(bytes(self.buffer))
+            self.buffer = bytearray()
+        super().close()
+
+
+class GzipIndex:
+    """
+    The seek points exported by indexed_gzip in the GZIDX format of its zran.c. Merging the seek points of several
+    exports makes it possible to add seek points to regions of an already complete index.
+    Each point is a tuple (compressed offset, uncompressed offset, bits, window or None).
+    """
+
+    MAGIC = b'GZIDX'
+    # fmt: off
+    HEADER      = struct.Struct('=5sBBQQIII')
+    POINT_V0    = struct.Struct('=QQB')
+    POINT_V1    = struct.Struct('=QQBB')
+    # fmt: on
+
+    def __init__(
+        # fmt: off
+        self,
+        version          : int,
+        flags            : int,
+        compressedSize   : int,
+        uncompressedSize : int,
+        spacing          : int,
+        windowSize       : int,
+        points           : List[Tuple[int, int, int, Optional[bytes]]],
+        # fmt: on
+    ) -> None:
+        # fmt: off
+        self.version          = version
+        self.flags            = flags
+        self.compressedSize   = compressedSize
+        self.uncompressedSize = uncompressedSize
+        self.spacing          = spacing
+        self.windowSize       = windowSize
+        self.points           = points
+        # fmt: on
+
+    @staticmethod
+    def fromDecoder(decoder: Any) -> 'GzipIndex':
+        """Exports the seek points of the given indexed_gzip.IndexedGzipFile."""
+        buffer = io.BytesIO()
+        decoder.export_index(fileobj=buffer)
+        buffer.seek(0)
+        return GzipIndex.read(buffer)
+
+    @staticmethod
+    def read(fileobj: IO[bytes], readWindows: bool = True) -> 'GzipIndex':
+        """If readWindows is false, only the seek point offsets are read and all windows are None."""
+        magic, version, flags, compressedSize, uncompressedSize, spacing, windowSize, count = GzipIndex.HEADER.unpack(
+            fileobj.read(GzipIndex.HEADER.size)
+        )
+        if magic != GzipIndex.MAGIC or version > 1:
+            raise ValueError("Unsupported gzip index format!")
+
+        pointStruct = GzipIndex.POINT_V1 if version >= 1 else GzipIndex.POINT_V0
+        points = []
+        for i in range(count):
+            values = pointStruct.unpack(fileobj.read(pointStruct.size))
+            # Version 0 stores windows for all but the first seek point.
+            hasWindow = values[3] if version >= 1 else i > 0
+            points.append((values[0], values[1], values[2], hasWindow))
+
+        result = []
+        for compressedOffset, uncompressedOffset, bits, hasWindow in points:
+            window = fileobj.read(windowSize) if hasWindow and readWindows else None
+            if window is not None and len(window) != windowSize:
+                raise ValueError("Truncated gzip index!")
+            result.append((compressedOffset, uncompressedOffset, bits, window))
+
+        return GzipIndex(version, flags, compressedSize, uncompressedSize, spacing, windowSize, result)
+
+    def write(self, fileobj: IO[bytes]) -> None:
+        fileobj.write(
+            GzipIndex.HEADER.pack(
+                GzipIndex.MAGIC,
+                self.version,
+                self.flags,
+                self.compressedSize,
+                self.uncompressedSize,
+                self.spacing,
+                self.windowSize,
+                len(self.points),
+            )
+        )
+        for compressedOffset, uncompressedOffset, bits, window in self.points:
+            if self.version >= 1:
+                fileobj.write(GzipIndex.POINT_V1.pack(compressedOffset, uncompressedOffset, bits, window is not None))
+            else:
+                fileobj.write(GzipIndex.POINT_V0.pack(compressedOffset, uncompressedOffset, bits))
+        for point in self.points:
+            if point[3] is not None:
+                fileobj.write(point[3])
+
+    def addPoints(self, points: List[Tuple[int, int, int, Optional[bytes]]]) -> int:
+        """
+        Inserts the given seek points at their position sorted by the uncompressed offset unless there already is
+        one at that offset. Returns the number of inserted points.
+        """
+        uncompressedOffsets = [point[1] for point in self.points]
+        insertedCount = 0
+        for point in points:
+            i = bisect.bisect_left(uncompressedOffsets, point[1])
+            if i < len(uncompressedOffsets) and uncompressedOffsets[i] == point[1]:
+                continue
+            uncompressedOffsets.insert(i, point[1])
+            self.points.insert(i, point)
+            insertedCount += 1
+        return insertedCount
+
+    def importInto(self, decoder: Any) -> None:
+        buffer = io.BytesIO()
+        self.write(buffer)
+        buffer.seek(0)
+        decoder.import_index(fileobj=buffer)
+
+
+class BlockCache:
+    """
+    A thread-safe least-recently-used cache for equally sized blocks of decompressed data.
+    The cache is bounded by the total size of all cached blocks in bytes.
+    """
+
+    def __init__(self, maxSize: int, blockSize: int = 1024 * 1024) -> None:
+        # fmt: off
+        self.maxSize   = maxSize
+        self.blockSize = blockSize
+        self.size      = 0
+        self.hits      = 0
+        self.misses    = 0
+        self.blocks: 'collections.OrderedDict[Any, bytes]' = collections.OrderedDict()
+        self.lock      = threading.Lock()
+        # fmt: on
+
+    def get(self, key: Any) -> Optional[bytes]:
+        """Returns the cached block for the given key or None if it is not cached."""
+        with self.lock:
+            block = self.blocks.get(key)
+            if block is None:
+                self.misses += 1
+            else:
+                self.hits += 1
+                self.blocks.move_to_end(key)
+            return block
+
+    def insert(self, key: Any, block: bytes) -> None:
+        with self.lock:
+            if key in self.blocks:
+                self.size -= len(self.blocks.pop(key))
+            self.blocks[key] = block
+            self.size += len(block)
+
+            while self.size > self.maxSize and self.blocks:
+                self.size -= len(self.blocks.popitem(last=False)[1])
+
+    def clear(self) -> None:
+        """Drops all cached blocks and resets the hit and miss counters, e.g., between benchmark runs."""
+        with self.lock:
+            self.blocks.clear()
+            self.size = self.hits = self.misses = 0
+
+    def statistics(self) -> Dict[str, int]:
+        """Returns the hit and miss counters and the current and maximum size of the cache."""
+        with self.lock:
+            return {'hits': self.hits, 'misses': self.misses, 'size': self.size, 'maxSize': self.maxSize}
+
+    def __contains__(self, key: Any) -> bool:
+        """Checks whether the key is cached without counting it as a hit or miss or changing its recency."""
+        with self.lock:
+            return key in self.blocks
+
+
+class BlockPrefetcher:
+    """
+    Detects sequential accesses to the blocks of one file and then decodes the next blocks into the BlockCache
+    in a background thread using its own file object, so that subsequent reads do not have to wait for the
+    decompressor. The cache itself serves as the buffer for the prefetched blocks.
+    """
+
+    def __init__(
+        self, cache: BlockCache, cacheKey: Any, openFileObject: Callable[[], Tuple[Any, ...]], prefetchCount: int
+    ) -> None:
+        """
+        openFileObject : Returns a tuple, whose first element is a new independent file object to the data cached
+                         under cacheKey. The other elements will be kept alive alongside it. It is called lazily
+                         by the first reader thread, which detects sequential access.
+        prefetchCount : The number of blocks to decode ahead of the currently accessed block.
+        """
+        # fmt: off
+        self.cache          = cache
+        self.cacheKey       = cacheKey
+        self.openFileObject = openFileObject
+        self.prefetchCount  = prefetchCount
+        self.fileObjects: Optional[Tuple[Any, ...]] = None
+        # A single worker suffices because the decompressor can only decode sequentially anyway.
+        # The parallel decoders will use multiple cores for it.
+        self.executor       = concurrent.futures.ThreadPoolExecutor(max_workers=1)
+        self.pending: Dict[int, concurrent.futures.Future] = {}
+        self.lastAccesses: typing.Deque[int] = collections.deque(maxlen=16)
+        self.lock           = threading.Lock()
+        self.closed         = False
+        # fmt: on
+
+    def notifyAccess(self, blockIndex: int) -> None:
+        """Should be called on each access to a block and will start prefetching on sequential access."""
+        with self.lock:
+            # Remember multiple accesses in order to detect sequential access even for concurrent readers.
+            isSequential = blockIndex - 1 in self.lastAccesses
+            if blockIndex not in self.lastAccesses:
+                self.lastAccesses.append(blockIndex)
+            if not isSequential or self.closed:
+                return
+
+            if self.fileObjects is None:
+                self.fileObjects = self.openFileObject()
+
+            for nextBlockIndex in range(blockIndex + 1, blockIndex + 1 + self.prefetchCount):
+                if nextBlockIndex not in self.pending and (self.cacheKey, nextBlockIndex) not in self.cache:
+                    self.pending[nextBlockIndex] = self.executor.submit(self._fetch, nextBlockIndex)
+
+    def wait(self, blockIndex: int) -> Optional[bytes]:
+        """Returns the block if it is currently being prefetched or None if it was not requested to be prefetched."""
+        with self.lock:
+            future = self.pending.get(blockIndex)
+        try:
+            return future.result() if future else None
+        except concurrent.futures.CancelledError:
+            return None
+
+    def _fetch(self, blockIndex: int) -> Optional[bytes]:
+        try:
+            assert self.fileObjects
+            fileObject = self.fileObjects[0]
+            fileObject.seek(blockIndex * self.cache.blockSize)
+            block = fileObject.read(self.cache.blockSize)
+            if block:
+                self.cache.insert((self.cacheKey, blockIndex), block)
+            return block
+        except Exception as exception:
+            if printDebug >= 1:
+                print("[Warning] Failed to prefetch block", blockIndex, "because of:", exception)
+            return None
+        finally:
+            with self.lock:
+                self.pending.pop(blockIndex, None)
+
+    def close(self) -> None:
+        """Cancels all pending prefetches, stops the worker thread, and closes the opened file objects."""
+        with self.lock:
+            self.closed = True
+            for future in self.pending.values():
+                future.cancel()
+            self.pending.clear()
+        self.executor.shutdown(wait=True)
+        with self.lock:
+            fileObjects, self.fileObjects = self.fileObjects, None
+        for fileObject in fileObjects or []:
+            if hasattr(fileObject, 'close'):
+                fileObject.close()
+
+
+class BlockCachedFile(io.BufferedIOBase):
+    """
+    A file abstraction layer, which reads the underlying file only in blocks of BlockCache.blockSize and answers
+    reads from the given BlockCache if possible. Multiple instances may share the same cache, e.g., to be used for
+    multiple file objects to the same file, as long as they are created with the same cache key.
+    """
+
+    def __init__(
+        self, fileobj: IO, cache: BlockCache, cacheKey: Any, prefetcher: Optional[BlockPrefetcher] = None
+    ) -> None:
+        # fmt: off
+        self.fileobj    = fileobj
+        self.cache      = cache
+        self.cacheKey   = cacheKey
+        self.prefetcher = prefetcher
+        self.offset     = 0
+        # fmt: on
+
+    def _getBlock(self, blockIndex: int) -> bytes:
+        key = (self.cacheKey, blockIndex)
+        if self.prefetcher:
+            self.prefetcher.notifyAccess(blockIndex)
+        block = self.cache.get(key)
+        if block is None and self.prefetcher:
+            block = self.prefetcher.wait(blockIndex)
+        if block is None:
+            self.fileobj.seek(blockIndex * self.cache.blockSize)
+            block = self.fileobj.read(self.cache.blockSize)
+            if block:
+                self.cache.insert(key, block)
+        return block
+
+    @overrides(io.BufferedIOBase)
+    def close(self) -> None:
+        # Don't close the object given to us
+        pass
+
+    @overrides(io.BufferedIOBase)
+    def fileno(self) -> int:
+        return self.fileobj.fileno()
+
+    @overrides(io.BufferedIOBase)
+    def seekable(self) -> bool:
+        return True
+
+    @overrides(io.BufferedIOBase)
+    def readable(self) -> bool:
+        return True
+
+    @overrides(io.BufferedIOBase)
+    def writable(self) -> bool:
+        return False
+
+    @overrides(io.BufferedIOBase)
+    def read(self, size: int = -1) -> bytes:
+        blockSize = self.cache.blockSize
+        result = []
+        while size != 0:
+            blockIndex, offsetInBlock = divmod(self.offset, blockSize)
+            block = self._getBlock(blockIndex)
+            chunk = block[offsetInBlock:] if size < 0 else block[offsetInBlock : offsetInBlock + size]
+            if not chunk:
+                break
+
+            result.append(chunk)
+            self.offset += len(chunk)
+            if size > 0:
+                size -= len(chunk)
+
+            # Only the last block of the file can be smaller than the block size
+            if len(block) < blockSize:
+                break
+
+        return result[0] if len(result) == 1 else b''.join(result)
+
+    @overrides(io.BufferedIOBase)
+    def seek(self, offset: int, whence: int = io.SEEK_SET) -> int:
+        if whence == io.SEEK_CUR:
+            self.offset += offset
+        elif whence == io.SEEK_END:
+            self.offset = self.fileobj.seek(offset, io.SEEK_END)
+        elif whence == io.SEEK_SET:
+            self.offset = offset
+
+        if self.offset < 0:
+            raise ValueError("Trying to seek before the start of the file!")
+        return self.offset
+
+    @overrides(io.BufferedIOBase)
+    def tell(self) -> int:
+        return self.offset
+
+
+class ObjectPool:
+    """
+    A thread-safe pool of objects like SQLite connections or (decompressed) file objects, which must not be used
+    by more than one thread at the same time. Objects are created on demand using the given factory, so the pool
+    grows up to the largest number of concurrent users or up to maxSize. Further users wait for a returned object.
+    """
+
+    def __init__(self, factory: Callable[[], Any], maxSize: Optional[int] = None) -> None:
+        self.factory = factory
+        self.maxSize = maxSize
+        self.objects: List[Any] = []
+        self.createdCount = 0
+        self.closed = False
+        self.lock = threading.Lock()
+        self.returned = threading.Condition(self.lock)
+
+    @contextlib.contextmanager
+    def acquire(self) -> Iterator[Any]:
+        """Returns an object, which is exclusively used by the caller until the with-statement is left."""
+        with self.lock:
+            while not self.objects and self.maxSize is not None and self.createdCount >= self.maxSize:
+                self.returned.wait()
+            pooledObject = self.objects.pop() if self.objects else None
+            if pooledObject is None:
+                self.createdCount += 1
+        if pooledObject is None:
+            try:
+                pooledObject = self.factory()
+            except Exception:
+                with self.lock:
+                    self.createdCount -= 1
+                    self.returned.notify()
+                raise
+
+        try:
+            yield pooledObject
+        finally:
+            with self.lock:
+                if not self.closed:
+                    self.objects.append(pooledObject)
+                self.returned.notify()
+            if self.closed:
+                ObjectPool._closeObject(pooledObject)
+
+    def close(self) -> None:
+        """Closes all pooled objects. Objects, which are currently in use, are closed when they are returned."""
+        with self.lock:
+            self.closed = True
+            objects, self.objects = self.objects, []
+        for pooledObject in objects:
+            ObjectPool._closeObject(pooledObject)
+
+    @staticmethod
+    def _closeObject(pooledObject: Any) -> None:
+        # The file objects are pooled as tuples of objects, which have to be kept alive together.
+        for member in pooledObject if isinstance(pooledObject, tuple) else [pooledObject]:
+            if hasattr(member, 'close'):
+                member.close()
+
+
+class PathBloomFilter:
+    """
+    A Bloom filter over file paths, which answers whether a path might be contained without false negatives.
+    It uses Python's built-in string hash, which is cached inside each string object but differs between
+    processes, so the filter must not be stored or shared with other processes.
+    """
+
+    # 10 bits per path with 7 hash functions result in a false positive rate of less than 1 %.
+    bitsPerPath = 10
+    hashCount = 7
+
+    def __init__(self, pathCount: int) -> None:
+        self.size = max(64, pathCount * self.bitsPerPath)
+        self.bits = bytearray((self.size + 7) // 8)
+
+    def _bitPositions(self, path: str) -> Iterator[int]:
+        # Double hashing: https://www.eecs.harvard.edu/~michaelm/postscripts/rsa2008.pdf
+        pathHash = hash(path)
+        hash1 = pathHash & 0xFFFFFFFF
+        hash2 = (pathHash >> 32) | 1
+        return ((hash1 + i * hash2) % self.size for i in range(self.hashCount))
+
+    def add(self, path: str) -> None:
+        for position in self._bitPositions(path):
+            self.bits[position >> 3] |= 1 << (position & 7)
+
+    def __contains__(self, path: str) -> bool:
+        # Most paths not contained are already rejected by one of the first bits.
+        for position in self._bitPositions(path):
+            if not self.bits[position >> 3] & (1 << (position & 7)):
+                return False
+        return True
+
+
+class PerformanceStatistics:
+    """
+    Thread-safe counters and latency histograms, which are cheap enough to always be enabled.
+    Latencies are sorted into buckets with power-of-two bounds in microseconds, i.e., bucket i contains the latencies
+    in [2^(i-1), 2^i) microseconds, from which approximate percentiles can be derived.
+    """
+
+    def __init__(self) -> None:
+        self.counters: Dict[str, int] = {}
+        # Maps each name to the number of latencies, their sum in seconds, and the counts for each bucket.
+        self.latencies: Dict[str, Tuple[int, float, List[int]]] = {}
+        self.lock = threading.Lock()
+
+    def count(self, name: str, value: int = 1) -> None:
+        with self.lock:
+            self.counters[name] = self.counters.get(name, 0) + value
+
+    def countMany(self, values: Dict[str, int]) -> None:
+        """Adds all given values to their counters at once in order to only acquire the lock once."""
+        with self.lock:
+            for name, value in values.items():
+                self.counters[name] = self.counters.get(name, 0) + value
+
+    def addLatency(self, name: str, seconds: float) -> None:
+        bucket = int(seconds * 1e6).bit_length()
+        with self.lock:
+            count, total, histogram = self.latencies.get(name, (0, 0.0, []))
+            if bucket >= len(histogram):
+                histogram.extend([0] * (bucket + 1 - len(histogram)))
+            histogram[bucket] += 1
+            self.latencies[name] = (count + 1, total + seconds, histogram)
+
+    def clear(self) -> None:
+        with self.lock:
+            self.counters.clear()
+            self.latencies.clear()
+
+    @staticmethod
+    def _percentile(histogram: List[int], count: int, fraction: float) -> int:
+        """Returns the upper bound in microseconds of the bucket containing the given fraction of all latencies."""
+        accumulated = 0
+        for bucket, bucketCount in enumerate(histogram):
+            accumulated += bucketCount
+            if accumulated >= fraction * count:
+                return 1 << bucket
+        return 1 << len(histogram)
+
+    def toDict(self) -> Dict[str, Any]:
+        """Returns all counters and latencies in a JSON-serializable dictionary."""
+        with self.lock:
+            counters = dict(sorted(self.counters.items()))
+            latencies = {name: (value[0], value[1], list(value[2])) for name, value in self.latencies.items()}
+
+        result: Dict[str, Any] = {'counters': counters, 'latencies': {}}
+        for name, (count, total, histogram) in sorted(latencies.items()):
+            # fmt: off
+            result['latencies'][name] = {
+                'count'        : count,
+                'totalSeconds' : total,
+                'meanUs'       : total / count * 1e6,
+                'p50Us'        : self._percentile(histogram, count, 0.5),
+                'p99Us'        : self._percentile(histogram, count, 0.99),
+                # Maps the exclusive upper bound of each bucket in microseconds to the number of latencies in it.
+                'histogramUs'  : {str(1 << bucket): n for bucket, n in enumerate(histogram) if n},
+            }
+            # fmt: on
+        return result
+
+
+# Global statistics for all archives and mounts of this process, see TarMount's /.ratarmount-stats special file.
+performanceStatistics = PerformanceStatistics()
+
+
+def timedOperation(name: str) -> Callable:
+    """
+    Decorator, which records the latency of each call to the decorated function or generator function and counts
+    the calls failing with an exception in performanceStatistics. For generators, the time until they are exhausted
+    is measured, which is what FUSE has to wait for when it collects all directory entries returned by readdir.
+    """
+
+    def decorator(function: Callable) -> Callable:
+        def recordException(exception: Exception) -> None:
+            performanceStatistics.count(name + '.errors')
+            if isinstance(exception, fuse.FuseOSError) and exception.errno == fuse.errno.ENOENT:
+                performanceStatistics.count(name + '.notFound')
+
+        if inspect.isgeneratorfunction(function):
+
+            @functools.wraps(function)
+            def generatorWrapper(*args, **kwargs):
+                startTime = timer()
+                try:
+                    yield from function(*args, **kwargs)
+                except Exception as exception:
+                    recordException(exception)
+                    raise
+                finally:
+                    performanceStatistics.addLatency(name, timer() - startTime)
+
+            return generatorWrapper
+
+        @functools.wraps(function)
+        def wrapper(*args, **kwargs):
+            startTime = timer()
+            try:
+                return function(*args, **kwargs)
+            except Exception as exception:
+                recordException(exception)
+                raise
+            finally:
+                performanceStatistics.addLatency(name, timer() - startTime)
+
+        return wrapper
+
+    return decorator
+
+
+# Names must be identical to the SQLite column headers!
+FileInfo = collections.namedtuple(
+    "FileInfo", "offsetheader offset size mtime mode type linkname uid gid istar issparse"
+)
+
+
+# The range of compression blocks or seek points, which have to be decoded in order to read a file.
+# The offsets and sizes are in bytes in the compressed archive. Files in the same blocks share the decoding costs.
+BlockRange = collections.namedtuple("BlockRange", "firstblock lastblock compressedoffset compressedsize")
+
+
+def _initializeIndexingWorker(debugLevel: int) -> None:
+    """Initializes a worker process for parallel index creation."""
+    global printDebug
+    printDebug = debugLevel
+    ProgressBar.enabled = False
+
+
+class SQLiteIndexedTar:
+    """
+    This class reads once through the whole TAR archive and stores TAR file offsets
+    for all contained files in an index to support fast seeking to a given file.
+    """
+
+    # Version 0.1.0:
+    #   - Initial version
+    # Version 0.2.0:
+    #   - Add sparse support and 'offsetheader' and 'issparse' columns to the SQLite database
+    #   - Add TAR file size metadata in order to quickly check whether the TAR changed
+    #   - Add 'offsetheader' to the primary key of the 'files' table so that files which were
+    #     updated in the TAR can still be accessed if necessary.
+    # Version 0.3.0:
+    #   - Add arguments influencing the created index to metadata (ignore-zeros, recursive, ...)
+    # Version 0.4.0:
+    #   - Add the optional compact schema with the "directories" and "compactfiles" tables and a "files" view
+    __version__ = '0.4.0'
+
+    # Number of rows to collect before inserting them all at once with executemany during index creation.
+    # See benchmarkInsertBatchSizes in benchmarks/scripts/benchmarkSqlite.py for the choice.
+    insertBatchSize = 1000
+
+    # Number of most recently listed directories to keep in memory because listing a directory is most often
+    # followed by a stat of each of its entries, e.g., by ls -l or find.
+    directoryCacheSize = 8
+    # Number of random reads into the same region between two gzip seek points after which seek points with
+    # gzipDenseSeekPointSpacing are added to it.
+    gzipHotRegionReadCount = 3
+    # Number of sparse maps of recently read sparse files to keep in memory.
+    sparseBlocksCacheSize = 16
+    # Gaps between files up to this size in bytes are decoded instead of seeking over them by readFiles.
+    bulkReadMaxSkipSize = 16 * 1024 * 1024
+    # SQLite page cache size in bytes per connection for indexMemoryMode 'mmap'. The default is only 2 MiB.
+    indexCacheSize = 64 * 1024 * 1024
+
+    # The queries run by getFileInfo. Python's sqlite3 module caches the prepared statements per connection
+    # by their SQL text, so using the same strings for each call reuses the already compiled statements.
+    _fileVersionsQuery = 'SELECT * FROM "files" WHERE "path" == (?) AND "name" == (?) ORDER BY "offsetheader" ASC'
+    _directoryQuery = 'SELECT * FROM "files" WHERE "path" == (?)'
+    _fileInfoQueries = {
+        order: 'SELECT * FROM "files" WHERE "path" == (?) AND "name" == (?) '
+        'ORDER BY "offsetheader" {} LIMIT 1 OFFSET (?);'.format(order)
+        for order in ['ASC', 'DESC']
+    }
+
+    def __init__(
+        # fmt: off
+        self,
+        tarFileName                : Optional[str]       = None,
+        fileObject                 : Optional[BinaryIO]  = None,
+        writeIndex                 : bool                = False,
+        clearIndexCache            : bool                = False,
+        indexFileName              : Optional[str]       = None,
+        indexFolders               : Optional[List[str]] = None,
+        recursive                  : bool                = False,
+        gzipSeekPointSpacing       : int                 = 4*1024*1024,
+        encoding                   : str                 = tarfile.ENCODING,
+        stripRecursiveTarExtension : bool                = False,
+        ignoreZeros                : bool                = False,
+        verifyModificationTime     : bool                = False,
+        parallelization            : int                 = 1,
+        threaded                   : bool                = False,
+        blockCache                 : Optional[BlockCache] = None,
+        prefetch                   : int                 = 0,
+        lazy                       : bool                = False,
+        inlineFileSizeLimit        : int                 = 0,
+        gzipDenseSeekPointSpacing  : int                 = 0,
+        compactIndex               : bool                = False,
+        indexMemoryMode            : str                 = 'disk',
+        joinSplitArchives          : bool                = False,
+        # fmt: on
+    ) -> None:
+        """
+        tarFileName : Path to the TAR file to be opened. If not specified, a fileObject must be specified.
+                      If only a fileObject is given, the created index can't be cached (efficiently).
+        fileObject : A io.IOBase derived object. If not specified, tarFileName will be opened.
+                     If it is an instance of IndexedBzip2File, IndexedGzipFile, or IndexedZstdFile, then the offset
+                     loading and storing from and to the SQLite database is managed automatically by this class.
+        encoding : Will be forwarded to tarfile. Specifies how filenames inside the TAR are encoded.
+        ignoreZeros : Will be forwarded to tarfile. Specifies to not only skip zero blocks but also blocks with
+                      invalid data. Setting this to true can lead to some problems but is required to correctly
+                      read concatenated tars.
+        stripRecursiveTarExtension : If true and if recursive is also true, then a <file>.tar inside the current
+                                     tar will be mounted at <file>/ instead of <file>.tar/.
+        parallelization : The number of threads to use for decoding bzip2 compressed TARs. If it is not 1, then the
+                          parallel bzip2 decoder is used, which searches block magic bytes ahead of time and decodes
+                          the found blocks in parallel. A value of 0 will use as many threads as there are cores.
+                          For zstd compressed TARs with multiple frames of known size, e.g., in the seekable
+                          format, the frames are decoded in parallel by ParallelZstdFile and for xz compressed TARs
+                          with multiple blocks, the blocks are decoded in parallel by ParallelXzFile.
+                          For uncompressed TARs, this is the number of processes used for indexing nested TARs
+                          in parallel when mounting recursively.
+        threaded : If true, then getFileInfo, read, and the other reading methods may be called from multiple threads
+                   at the same time. Each concurrent caller will get its own read-only SQLite connection to the index
+                   and its own file object and decompressor to the TAR from a pool. Requires tarFileName to be set.
+        blockCache : If specified, reads from compressed TARs will be served from and stored into this cache of
+                     decompressed blocks. The cache may be shared between multiple SQLiteIndexedTar instances.
+        prefetch : The number of blocks to decode ahead in a background thread into the blockCache when sequential
+                   reads are detected. Requires blockCache and tarFileName to be set.
+        lazy : If true, the compression offsets stored in an already existing index are only loaded into the
+               decompressor when it is needed for the first time, i.e., on the first read.
+        inlineFileSizeLimit : When creating the index, the contents of regular files not larger than this size in
+                              bytes will be stored in the index, so that they can be read without decompression.
+                              A value of 0 disables this.
+        gzipDenseSeekPointSpacing : If greater than 0, regions of gzip-compressed TARs between two seek points, which
+                                    are read randomly multiple times, get additional seek points with this spacing.
+                                    These are also stored in the index if it is writable. This makes it possible
+                                    to use a coarse gzipSeekPointSpacing without slowing down frequent accesses.
+        compactIndex : If true, a newly created index stores each parent path only once in a "directories" table
+                       and refers to it by an integer id. This makes indexes of deep trees with many files smaller.
+                       Existing indexes are loaded in whichever schema they were created with.
+        indexMemoryMode : Specifies how the index is accessed after it has been loaded or created in order to speed
+                          up lookups for many files, e.g., by find or ls -R.
+                          'disk' : Use SQLite's default page cache.
+                          'mmap' : Memory-map the index file and use a page cache of indexCacheSize per connection.
+                          'memory' : Copy the whole index into an in-memory database, from which all lookups are
+                                     answered. Changes to the index file made afterward are not copied.
+        joinSplitArchives : If true and tarFileName is the first part of a split archive, e.g., archive.tar.001,
+                            then all consecutively numbered parts are read as one concatenated archive. This is
+                            not the default because numbered files might also be independent archives.
+        """
+
+        self._initializeMembers(
+            # fmt: off
+            recursive                  = recursive,
+            gzipSeekPointSpacing       = gzipSeekPointSpacing,
+            encoding                   = encoding,
+            stripRecursiveTarExtension = stripRecursiveTarExtension,
+            ignoreZeros                = ignoreZeros,
+            verifyModificationTime     = verifyModificationTime,
+            parallelization            = parallelization,
+            threaded                   = threaded,
+            blockCache                 = blockCache,
+            inlineFileSizeLimit        = inlineFileSizeLimit,
+            gzipDenseSeekPointSpacing  = gzipDenseSeekPointSpacing,
+            compactIndex               = compactIndex,
+            indexMemoryMode            = indexMemoryMode,
+            # fmt: on
+        )
+
+        if not tarFileName:
+            if not fileObject:
+                raise ValueError("At least one of tarFileName and fileObject arguments should be set!")
+            self.tarFileName = '<file object>'
+            self.tarFileParts: List[str] = []
+            SQLiteIndexedTar._persistRemoteChunks(fileObject, False)
+            self.tarFileObject, self.rawFileObject, self.compression, self.isTar = SQLiteIndexedTar._openCompressedFile(
+                fileObject, gzipSeekPointSpacing, encoding, parallelization
+            )
+            self._openParallelZstdFile()
+            self._createIndex(self.tarFileObject)
+            SQLiteIndexedTar._persistRemoteChunks(fileObject, True)
+            self._initializeThreadedAccess()
+            # return here because we can't find a save location without any identifying name
+            return
+
+        self.tarFileName = tarFileName if isRemotePath(tarFileName) else os.path.abspath(tarFileName)
+        # All parts of a split archive, which will be read as one concatenated file, or only tarFileName.
+        self.tarFileParts = findSplitArchiveParts(self.tarFileName) if joinSplitArchives else [self.tarFileName]
+        fileSize = None
+        if not fileObject:
+            fileObject = SQLiteIndexedTar._openTarFileParts(self.tarFileParts)
+            fileObject.seek(0, io.SEEK_END)
+            fileSize = fileObject.tell()
+            fileObject.seek(0)
+        # The chunks of remote archives read for detecting the compression and for creating the index are not
+        # expected to be read again and would only fill up the on-disk cache. See _persistRemoteChunks.
+        SQLiteIndexedTar._persistRemoteChunks(fileObject, False)
+
+        # rawFileObject : Only set when opening a compressed file and only kept to keep the
+        #                 compressed file handle from being closed by the garbage collector.
+        # tarFileObject : File object to the uncompressed (or decompressed) TAR file to read actual data out of.
+        # compression   : Stores what kind of compression the originally specified TAR file uses.
+        # isTar         : Can be false for the degenerated case of only a bz2 or gz file not containing a TAR
+        self.tarFileObject, self.rawFileObject, self.compression, self.isTar = SQLiteIndexedTar._openCompressedFile(
+            fileObject, gzipSeekPointSpacing, encoding, parallelization
+        )
+        # Uncompressed TARs are not read through the block cache, see _withBlockCache.
+        if self.blockCache and prefetch > 0 and self.compression:
+            self.blockPrefetcher = BlockPrefetcher(self.blockCache, self.tarFileName, self._openTarFileObject, prefetch)
+
+        if self.compression == 'xz':
+            try:
+                blockBoundaries = getattr(self.tarFileObject, 'block_boundaries', [])
+                if len(blockBoundaries) <= 1 and (fileSize is None or fileSize > 1024 * 1024):
+                    print("[Warning] The specified file '{}'".format(self.tarFileName))
+                    print("[Warning] is compressed using xz but only contains one xz block. This makes it ")
+                    print("[Warning] impossible to use true seeking! Please (re)compress your TAR using pixz")
+                    print("[Warning] (see https://github.com/vasi/pixz) in order for ratarmount to do be able ")
+                    print("[Warning] to do fast seeking to requested files.")
+                    print("[Warning] As it is, each file access will decompress the whole TAR from the beginning!")
+                    print()
+            except Exception:
+                pass
+
+        # will be used for storing indexes if current path is read-only
+        # The query of remote URLs, e.g., the signature of presigned URLs, is not part of the index location.
+        tarFileName = RemoteFile.stripQuery(self.tarFileName) if isRemotePath(self.tarFileName) else self.tarFileName
+        possibleIndexFilePaths = [tarFileName + ".index.sqlite"]
+        indexPathAsName = tarFileName.replace("/", "_") + ".index.sqlite"
+        if isinstance(indexFolders, str):
+            indexFolders = [indexFolders]
+        if indexFileName:
+            # A given index file name takes precedence and there should be no implicit fallback
+            possibleIndexFilePaths = [os.path.abspath(os.path.expanduser(indexFileName))]
+        elif indexFolders:
+            # An empty path is to be interpreted as the default path right besides the TAR
+            if '' not in indexFolders:
+                possibleIndexFilePaths = []
+            for folder in indexFolders:
+                if folder:
+                    indexPath = os.path.join(folder, indexPathAsName)
+                    possibleIndexFilePaths.append(os.path.abspath(os.path.expanduser(indexPath)))
+
+        if clearIndexCache:
+            for indexPath in possibleIndexFilePaths:
+                if os.path.isfile(indexPath):
+                    os.remove(indexPath)
+
+        # Try to find an already existing index
+        for indexPath in possibleIndexFilePaths:
+            if isRemotePath(indexPath):
+                # An index next to a remote archive can't be removed or written to but a local copy can be used.
+                localIndexPath = None if clearIndexCache else self._downloadRemoteIndex(indexPath)
+                if not localIndexPath:
+                    continue
+                indexPath = localIndexPath
+            if self._tryLoadIndex(indexPath):
+                self.indexFileName = indexPath
+                break
+        if self.indexIsLoaded():
+            if self.indexAppendInfo:
+                self._appendToIndex(self.indexAppendInfo[1])
+            self._openParallelZstdFile()
+            if not lazy:
+                self._loadOrStoreCompressionOffsets()
+            self._initializeIndexMemoryMode()
+            self._initializeThreadedAccess()
+            SQLiteIndexedTar._persistRemoteChunks(fileObject, True)
+            return
+
+        # Find a suitable (writable) location for the index database
+        if writeIndex:
+            for indexPath in possibleIndexFilePaths:
+                if isRemotePath(indexPath):
+                    continue
+                if self._pathIsWritable(indexPath) and self._pathCanBeUsedForSqlite(indexPath):
+                    self.indexFileName = indexPath
+                    break
+
+        if not self.indexFileName:
+            raise InvalidIndexError(
+                "Could not find any existing index or writable location for an index in " + str(possibleIndexFilePaths)
+            )
+
+        self._openParallelZstdFile()
+        self._createIndex(self.tarFileObject)
+        self._loadOrStoreCompressionOffsets()  # store
+        if self.sqlConnection:
+            self._storeMetadata(self.sqlConnection)
+        self._initializeIndexMemoryMode()
+        self._initializeThreadedAccess()
+        SQLiteIndexedTar._persistRemoteChunks(fileObject, True)
+
+        if printDebug >= 1 and writeIndex:
+            # The 0-time is legacy for the automated tests
+            # fmt: off
+            print("Writing out TAR index to", self.indexFileName, "took 0s",
                   "and is sized", os.stat( self.indexFileName ).st_size, "B")
             # fmt: on
 
+    def _initializeMembers(
+        # fmt: off
+        self,
+        recursive                  : bool                 = False,
+        gzipSeekPointSpacing       : int                  = 4*1024*1024,
+        encoding                   : str                  = tarfile.ENCODING,
+        stripRecursiveTarExtension : bool                 = False,
+        ignoreZeros                : bool                 = False,
+        verifyModificationTime     : bool                 = False,
+        parallelization            : int                  = 1,
+        threaded                   : bool                 = False,
+        blockCache                 : Optional[BlockCache] = None,
+        inlineFileSizeLimit        : int                  = 0,
+        gzipDenseSeekPointSpacing  : int                  = 0,
+        compactIndex               : bool                 = False,
+        indexMemoryMode            : str                  = 'disk',
+        # fmt: on
+    ) -> None:
+        """
+        Initializes the members for the given options, which are described in __init__, and for an index, which
+        is not opened yet. This is shared with _createNestedIndex, so that the indexers in the worker processes
+        have the same members as the constructed objects.
+        """
+        # stores which parent folders were last tried to add to database and therefore do exist
+        self.parentFolderCache: List[Tuple[str, str]] = []
+        # rows which are not yet inserted into the database, see _flushFileInfos
+        self.fileInfosToInsert: List[tuple] = []
+        self.parentFoldersToInsert: List[Tuple[str, str]] = []
+        # recently listed directories: path -> { name : FileInfo }, see _getCachedFileInfo
+        self.directoryCache: 'collections.OrderedDict[str, Dict[str, FileInfo]]' = collections.OrderedDict()
+        self.directoryCacheLock = threading.Lock()
+        self.sqlConnection: Optional[sqlite3.Connection] = None
+        # Only used in threaded mode. Else, sqlConnection and tarFileObject are used directly.
+        self.sqlConnectionPool: Optional[ObjectPool] = None
+        self.tarFileObjectPool: Optional[ObjectPool] = None
+        self.blockPrefetcher: Optional[BlockPrefetcher] = None
+        # Whether self.tarFileObject has been initialized with the offsets and seek points stored in the index.
+        self.compressionOffsetsLoaded = False
+        # Whether the index contains the "inlinefiles" table, see inlineFileSizeLimit
+        self.hasInlineFiles = False
+        # The inlineFileSizeLimit the index was created with. Larger files are not looked up in "inlinefiles".
+        self.indexInlineFileSizeLimit = 0
+        # Whether the index contains the "sparseblocks" table. Older indexes require tarfile to read sparse files.
+        self.hasSparseBlocks = False
+        # offsetheader -> (expanded block offsets, blocks) for recently read sparse files, see _getSparseBlocks
+        self.sparseBlocksCache: 'collections.OrderedDict[int, Tuple[List[int], List[tuple]]]'
+        self.sparseBlocksCache = collections.OrderedDict()
+        self.sparseBlocksCacheLock = threading.Lock()
+        # (decompressed offsets, compressed offsets) of all compression blocks or seek points, see getBlockRange
+        self.compressionBlocks: Optional[Tuple[List[int], List[int]]] = None
+        self.compressionBlocksUnavailable = False
+        # Read-only memory map of uncompressed TARs, which can be sliced from multiple threads without any seeking.
+        self.tarFileMap: Optional[mmap.mmap] = None
+        self.tarFileMapIsSupported = True
+        self.tarFileMapLock = threading.Lock()
+        # For gzipDenseSeekPointSpacing: the number of random reads per coarse region and the already densified ones.
+        # These are counted by all reading threads and therefore guarded by gzipDensificationLock.
+        self.gzipRegionReadCounts: Dict[int, int] = {}
+        self.gzipDensifiedRegions: Set[int] = set()
+        self.gzipLastReadEnd = 0
+        self.gzipDensificationLock = threading.Lock()
+        # The seek points are added by a single background thread, see _densifyGzipRegion.
+        self.gzipDensificationExecutor: Optional[concurrent.futures.ThreadPoolExecutor] = None
+        self.gzipDensificationClosed = False
+        # Seek points added in this session by their uncompressed offset. Only accessed by the background thread.
+        self.gzipAddedSeekPoints: Dict[int, Tuple[int, int, int, Optional[bytes]]] = {}
+        # (decoder, raw file object) with the added seek points, which replaces tarFileObject on the next read.
+        self.gzipDensifiedFileObjects: Optional[Tuple[Any, Any]] = None
+        # Serializes the accesses to sqlConnection and sqlMemoryConnection when there is no connection pool.
+        self.sqlConnectionLock = threading.RLock()
+        # (header offset of the last member, offset after it) for uncompressed TARs, see _appendToIndex
+        self.tarAppendInfo: Optional[Tuple[int, int]] = None
+        # Set by loadIndex if the TAR only has grown since the index was created, e.g., by tar -r.
+        self.indexAppendInfo: Optional[Tuple[int, int]] = None
+        # path -> id in the "directories" table of the compact index for the paths inserted during index creation
+        self.directoryIds: Dict[str, int] = {}
+        # Copy of the index for indexMemoryMode 'memory', which is used for all reads. See _loadIndexIntoMemory.
+        self.sqlMemoryConnection: Optional[sqlite3.Connection] = None
+        self.sqlMemoryUri: Optional[str] = None
+        # None for indexes only created in memory for a given file object
+        self.indexFileName: Optional[str] = None
+
+        # fmt: off
+        self.mountRecursively           = recursive
+        self.encoding                   = encoding
+        self.stripRecursiveTarExtension = stripRecursiveTarExtension
+        self.ignoreZeros                = ignoreZeros
+        self.verifyModificationTime     = verifyModificationTime
+        self.gzipSeekPointSpacing       = gzipSeekPointSpacing
+        self.parallelization            = parallelization
+        self.threaded                   = threaded
+        self.blockCache                 = blockCache
+        self.inlineFileSizeLimit        = inlineFileSizeLimit
+        self.gzipDenseSeekPointSpacing  = gzipDenseSeekPointSpacing
+        self.compactIndex               = compactIndex
+        self.indexMemoryMode            = indexMemoryMode
+        # fmt: on
+
+        if indexMemoryMode not in ['disk', 'mmap', 'memory']:
+            raise ValueError("The index memory mode must be one of 'disk', 'mmap', or 'memory'!")
+
     def _storeMetadata(self, connection: sqlite3.Connection) -> None:
         self._storeVersionsMetadata(connection)
 
@@ -472,10 +2614,82 @@ class SQLiteIndexedTar:
 
         connection.executescript(metadataTable)
 
-        # All of these require the generic "metadata" table.
-        self._storeTarMetadata(connection, self.tarFileName)
-        self._storeArgumentsMetadata(connection)
-        connection.commit()
+        # All of these require the generic "metadata" table.
+        self._storeTarMetadata(connection, self.tarFileName)
+        if len(self.tarFileParts) > 1:
+            self._storeTarPartsMetadata(connection, self.tarFileParts)
+        self._storeTarAppendMetadata(connection)
+        self._storeArgumentsMetadata(connection)
+        connection.commit()
+
+    def _storeTarAppendMetadata(self, connection: sqlite3.Connection) -> None:
+        """
+        Stores where members appended to an uncompressed TAR, e.g., with tar -r, will begin and a checksum of the
+        header of the last member, with which _findAppendInfo can check that the TAR only has grown.
+        """
+        if not self.tarAppendInfo or self.compression or len(self.tarFileParts) > 1:
+            return
+
+        lastHeaderOffset, appendOffset = self.tarAppendInfo
+        try:
+            self.tarFileObject.seek(lastHeaderOffset)
+            checksum = zlib.crc32(self.tarFileObject.read(tarfile.BLOCKSIZE))
+            serializedAppendInfo = json.dumps(
+                {'lastheader': lastHeaderOffset, 'offset': appendOffset, 'crc32': checksum}
+            )
+            connection.execute('INSERT INTO "metadata" VALUES (?,?)', ("tarappend", serializedAppendInfo))
+        except Exception as exception:
+            if printDebug >= 2:
+                print(exception)
+            print("[Warning] There was an error when adding the offset for appending to the TAR to the metadata.")
+            print("[Warning] The index will be recreated instead of extended when the TAR file grows.")
+
+    def _findAppendInfo(
+        self, metadata: Dict[str, str], oldSize: int, indexFileName: AnyStr
+    ) -> Optional[Tuple[int, int]]:
+        """
+        Returns the information stored by _storeTarAppendMetadata if the TAR file has only grown since the index
+        was created, so that it suffices to add the appended members to the index. Returns None otherwise.
+        """
+        if (
+            'tarappend' not in metadata
+            or self.compression
+            or len(self.tarFileParts) > 1
+            or not os.access(indexFileName, os.W_OK)
+            or statPath(self.tarFileName).st_size <= oldSize
+        ):
+            return None
+
+        values = json.loads(metadata['tarappend'])
+        oldOffset = self.tarFileObject.tell()
+        try:
+            self.tarFileObject.seek(values['lastheader'])
+            if zlib.crc32(self.tarFileObject.read(tarfile.BLOCKSIZE)) != values['crc32']:
+                return None
+        finally:
+            self.tarFileObject.seek(oldOffset)
+        return values['lastheader'], values['offset']
+
+    def _appendToIndex(self, appendOffset: int) -> None:
+        """
+        Adds the members, which were appended to the TAR after the index was created, to the index. Only the new
+        part of the TAR starting at appendOffset, where the end-of-archive marker was before, is scanned.
+        """
+        if not self.sqlConnection:
+            raise IndexNotOpenError("This method can not be called without an opened index database!")
+
+        if printDebug >= 1:
+            print("[Info] The TAR file has grown since the index was created. Only the new part will be indexed.")
+
+        self.tarAppendInfo = self.indexAppendInfo
+        self.tarFileObject.seek(appendOffset)
+        self._createIndex(self.tarFileObject, appendToIndex=True)
+        self.indexAppendInfo = None
+
+        self.sqlConnection.execute('DELETE FROM "metadata" WHERE "key" IN ("tarstats", "tarappend");')
+        self._storeTarMetadata(self.sqlConnection, self.tarFileName)
+        self._storeTarAppendMetadata(self.sqlConnection)
+        self.sqlConnection.commit()
 
     @staticmethod
     def _storeVersionsMetadata(connection: sqlite3.Connection) -> None:
@@ -519,9 +2733,10 @@ class SQLiteIndexedTar:
                 makeVersionRow('index', SQLiteIndexedTar.__version__),
             ]
 
-            for _, cinfo in supportedCompressions.items():
-                if cinfo.moduleName in globals():
-                    versions += [makeVersionRow(cinfo.moduleName, globals()[cinfo.moduleName].__version__)]
+            # Standard library modules like lzma have no version of their own.
+            for moduleName in [cinfo.moduleName for cinfo in supportedCompressions.values()] + ['lzmaffi']:
+                if moduleName in globals() and hasattr(globals()[moduleName], '__version__'):
+                    versions += [makeVersionRow(moduleName, globals()[moduleName].__version__)]
 
             connection.executemany('INSERT OR REPLACE INTO "versions" VALUES (?,?,?,?,?)', versions)
         except Exception as exception:
@@ -533,7 +2748,7 @@ class SQLiteIndexedTar:
     def _storeTarMetadata(connection: sqlite3.Connection, tarPath: AnyStr) -> None:
         """Adds some consistency meta information to recognize the need to update the cached TAR index"""
         try:
-            tarStats = os.stat(tarPath)
+            tarStats = statPath(tarPath)
             serializedTarStats = json.dumps(
                 {attr: getattr(tarStats, attr) for attr in dir(tarStats) if attr.startswith('st_')}
             )
@@ -544,6 +2759,20 @@ class SQLiteIndexedTar:
             print("[Warning] There was an error when adding file metadata.")
             print("[Warning] Automatic detection of changed TAR files during index loading might not work.")
 
+    @staticmethod
+    def _storeTarPartsMetadata(connection: sqlite3.Connection, tarFileParts: List[str]) -> None:
+        """Adds the sizes and modification times of all parts of a split archive to detect changed parts."""
+        try:
+            serializedPartsStats = json.dumps(
+                [{'st_size': statPath(part).st_size, 'st_mtime': statPath(part).st_mtime} for part in tarFileParts]
+            )
+            connection.execute('INSERT INTO "metadata" VALUES (?,?)', ("tarparts", serializedPartsStats))
+        except Exception as exception:
+            if printDebug >= 2:
+                print(exception)
+            print("[Warning] There was an error when adding metadata for the parts of the split archive.")
+            print("[Warning] Automatic detection of changed parts during index loading might not work.")
+
     def _storeArgumentsMetadata(self, connection: sqlite3.Connection) -> None:
         argumentsToSave = [
             'mountRecursively',
@@ -551,6 +2780,7 @@ class SQLiteIndexedTar:
             'encoding',
             'stripRecursiveTarExtension',
             'ignoreZeros',
+            'inlineFileSizeLimit',
         ]
 
         argumentsMetadata = json.dumps({argument: getattr(self, argument) for argument in argumentsToSave})
@@ -563,6 +2793,22 @@ class SQLiteIndexedTar:
             print("[Warning] There was an error when adding argument metadata.")
             print("[Warning] Automatic detection of changed arguments files during index loading might not work.")
 
+    @staticmethod
+    def _downloadRemoteIndex(url: str) -> Optional[str]:
+        """
+        Downloads the index next to a remote archive into the remote cache folder if it exists and returns the path
+        to the local copy. Returns None if there is no such index or if it could not be downloaded.
+        """
+        if not RemoteFile.cacheFolder:
+            return None
+        path = os.path.join(RemoteFile.cacheFolder, hashlib.sha256(url.encode()).hexdigest()[:32] + '.index.sqlite')
+        try:
+            return path if RemoteFile.download(url, path) else None
+        except (OSError, RatarmountError) as exception:
+            print("[Warning] Could not download the remote index:", url)
+            print("[Info] Exception:", exception)
+        return None
+
     @staticmethod
     def _pathIsWritable(path: AnyStr) -> bool:
         try:
@@ -609,7 +2855,9 @@ class SQLiteIndexedTar:
 
     @staticmethod
     def _openSqlDb(path: AnyStr) -> sqlite3.Connection:
-        sqlConnection = sqlite3.connect(path)
+        # In threaded mode, FUSE threads also write to the index, e.g., more gzip seek points. The accesses are
+        # serialized by locks or by the pool of connections for in-memory indexes, see _initializeThreadedAccess.
+        sqlConnection = sqlite3.connect(path, check_same_thread=False)
         sqlConnection.row_factory = sqlite3.Row
         sqlConnection.executescript(
             """
@@ -622,11 +2870,225 @@ class SQLiteIndexedTar:
         return sqlConnection
 
     @staticmethod
-    def _initializeSqlDb(indexFileName: Optional[str]) -> sqlite3.Connection:
+    def _openReadOnlySqlDb(path: str) -> sqlite3.Connection:
+        """
+        In contrast to _openSqlDb, does not use the exclusive locking mode, so that multiple of these connections
+        can read at the same time. The connection may be used from threads other than the creating one.
+        """
+        uri = 'file:' + urllib.parse.quote(os.path.abspath(path)) + '?mode=ro'
+        sqlConnection = sqlite3.connect(uri, uri=True, check_same_thread=False)
+        sqlConnection.row_factory = sqlite3.Row
+        sqlConnection.executescript('PRAGMA TEMP_STORE = MEMORY;')
+        return sqlConnection
+
+    def _initializeThreadedAccess(self) -> None:
+        """
+        Should be called after the index has been completely loaded or created. Sets up the pools of SQLite
+        connections and decompressed file objects, which are used for accessing the TAR from multiple threads.
+        """
+        if not self.threaded or not self.sqlConnection:
+            return
+
+        if not self.indexFileName:
+            # An index, which only exists in memory, can't be opened again by other connections. Therefore, all
+            # threads take turns with the one connection and the one file object.
+            connection = self.sqlMemoryConnection if self.sqlMemoryConnection else self.sqlConnection
+            self.sqlConnectionPool = ObjectPool(lambda: connection, maxSize=1)
+            fileObjects = (getattr(self, 'tarFileObject', None), getattr(self, 'rawFileObject', None))
+            self.tarFileObjectPool = ObjectPool(lambda: fileObjects, maxSize=1)
+            return
+
+        # The exclusive lock held after writing the index would block all other connections.
+        # Switching back to the normal locking mode only releases the lock on the next access.
+        self.sqlConnection.executescript('PRAGMA LOCKING_MODE = NORMAL;')
+        self.sqlConnection.execute('SELECT COUNT(*) FROM sqlite_master;').fetchone()
+
+        indexFileName = self.indexFileName
+        memoryUri = self.sqlMemoryUri
+        if memoryUri:
+            self.sqlConnectionPool = ObjectPool(lambda: SQLiteIndexedTar._openSharedMemorySqlDb(memoryUri))
+        else:
+            self.sqlConnectionPool = ObjectPool(
+                lambda: self._tuneSqlConnection(SQLiteIndexedTar._openReadOnlySqlDb(indexFileName))
+            )
+        self.tarFileObjectPool = ObjectPool(self._openTarFileObject)
+
+    def _initializeIndexMemoryMode(self) -> None:
+        """Should be called after the index has been completely loaded or created. See indexMemoryMode."""
+        if not self.sqlConnection:
+            return
+
+        if self.indexMemoryMode == 'mmap':
+            self._tuneSqlConnection(self.sqlConnection)
+        elif self.indexMemoryMode == 'memory':
+            self._loadIndexIntoMemory()
+
+    def _tuneSqlConnection(self, connection: sqlite3.Connection) -> sqlite3.Connection:
+        """Applies the settings for indexMemoryMode 'mmap' to the given connection to the index file."""
+        if self.indexMemoryMode == 'mmap' and self.indexFileName:
+            # SQLite limits the memory map to SQLITE_MAX_MMAP_SIZE, which might be smaller than the index.
+            connection.execute('PRAGMA mmap_size = {};'.format(os.stat(self.indexFileName).st_size + 1024 * 1024))
+            connection.execute('PRAGMA cache_size = {};'.format(-(self.indexCacheSize // 1024)))
+        return connection
+
+    def _loadIndexIntoMemory(self) -> None:
+        """
+        Copies the index into an in-memory database, which is used by _sqlConnectionForReading. The connection to
+        the index file is kept for writing, e.g., more gzip seek points. In threaded mode, the pooled connections
+        read from the same in-memory database in SQLite's shared-cache mode instead of each holding a copy.
+        """
+        if not self.sqlConnection:
+            return
+
+        t0 = time.time()
+        if self.threaded and self.indexFileName:
+            self.sqlMemoryUri = 'file:ratarmount-{}-{}?mode=memory&cache=shared'.format(os.getpid(), id(self))
+            connection = SQLiteIndexedTar._openSharedMemorySqlDb(self.sqlMemoryUri)
+        else:
+            connection = sqlite3.connect(':memory:', check_same_thread=False)
+            connection.row_factory = sqlite3.Row
+        self.sqlConnection.backup(connection)
+        self.sqlMemoryConnection = connection
+
+        if printDebug >= 1:
+            print("Loading the index into memory took {:.2f}s".format(time.time() - t0))
+
+    @staticmethod
+    def _openSharedMemorySqlDb(uri: str) -> sqlite3.Connection:
+        """Opens another connection to the in-memory database created by _loadIndexIntoMemory in threaded mode."""
+        sqlConnection = sqlite3.connect(uri, uri=True, check_same_thread=False)
+        sqlConnection.row_factory = sqlite3.Row
+        # Nothing is written to the in-memory copy, so reading does not need to acquire any table locks.
+        sqlConnection.executescript('PRAGMA read_uncommitted = 1;')
+        return sqlConnection
+
+    def _openTarFileObject(self) -> Tuple[Any, Any]:
+        """
+        Opens another independent (decompressed) file object to the TAR and initializes it with the block offsets
+        or seek points stored in the index. Returns the tuple (tar_file_obj, raw_file_obj).
+        The raw file object also has to be kept alive because some decompressors only work on its file descriptor.
+        """
+        rawFileObject = SQLiteIndexedTar._openTarFileParts(self.tarFileParts)
+        if self.compression not in supportedCompressions:
+            return rawFileObject, rawFileObject
+
+        with self._sqlConnectionForReading() as connection:
+            tarFileObject = SQLiteIndexedTar._openDecompressor(
+                rawFileObject,
+                self.compression,
+                self.gzipSeekPointSpacing,
+                self.parallelization,
+                self._readZstdFrameOffsets(connection),
+            )
+            if not self._loadCompressionOffsets(connection, tarFileObject):
+                print("[Warning] Could not load the compression offsets for", self.tarFileName)
+                print("[Warning] Seeking inside the TAR might be very slow.")
+        return tarFileObject, rawFileObject
+
+    @staticmethod
+    def _openTarFileParts(tarFileParts: List[str]) -> IO[bytes]:
+        """Opens the TAR file or the parts of a split archive as one concatenated file object."""
+        if len(tarFileParts) == 1:
+            return openPath(tarFileParts[0])
+        return typing.cast(IO[bytes], JoinedFile([openPath(part) for part in tarFileParts]))
+
+    @staticmethod
+    def _persistRemoteChunks(fileObject: Any, persist: bool) -> None:
+        """
+        Enables or disables storing the fetched chunks in the on-disk cache for the given remote file or for the
+        remote parts of the given joined file. Creating the index reads the whole archive once, which would
+        otherwise copy all of it into the cache even though only the chunks read for accessing members are worth
+        keeping.
+        """
+        fileObjects = fileObject.fileobjs if isinstance(fileObject, JoinedFile) else [fileObject]
+        for part in fileObjects:
+            if isinstance(part, RemoteFile):
+                part.persistChunks = persist
+
+    @contextlib.contextmanager
+    def _sqlConnectionForReading(self) -> Iterator[sqlite3.Connection]:
+        """Returns a connection to the index, which can be used safely by the current thread."""
+        if self.sqlConnectionPool:
+            with self.sqlConnectionPool.acquire() as connection:
+                yield connection
+            return
+
+        # The background thread adding gzip seek points might use the connection at the same time.
+        with self.sqlConnectionLock:
+            if self.sqlMemoryConnection:
+                yield self.sqlMemoryConnection
+                return
+
+            if not self.sqlConnection:
+                raise IndexNotOpenError("This method can not be called without an opened index database!")
+            yield self.sqlConnection
+
+    @contextlib.contextmanager
+    def _tarFileObjectForReading(self) -> Iterator[Any]:
+        """Returns a file object to the (decompressed) TAR, which can be used safely by the current thread."""
+        if self.tarFileObjectPool:
+            with self.tarFileObjectPool.acquire() as fileObjects:
+                yield self._withBlockCache(fileObjects[0])
+            return
+
+        if not self.compressionOffsetsLoaded:
+            self._loadOrStoreCompressionOffsets()
+        if self.gzipDensifiedFileObjects:
+            with self.gzipDensificationLock:
+                densifiedFileObjects = self.gzipDensifiedFileObjects
+                self.gzipDensifiedFileObjects = None
+            if densifiedFileObjects:
+                # The raw file object is left to the garbage collector because it might have been passed by the caller.
+                self.tarFileObject.close()
+                self.tarFileObject, self.rawFileObject = densifiedFileObjects
+        yield self._withBlockCache(self.tarFileObject)
+
+    def _tarFileMapForReading(self) -> Optional[mmap.mmap]:
+        """
+        Returns a memory map of the uncompressed TAR file or None if the TAR is compressed or can't be mapped.
+        The map is created on first use and shared by all threads. Use _tarFileMapIsBacked before slicing it.
+        """
+        if self.tarFileMap or not self.tarFileMapIsSupported:
+            return self.tarFileMap
+
+        with self.tarFileMapLock:
+            if not self.tarFileMap and self.tarFileMapIsSupported:
+                self.tarFileMapIsSupported = False
+                # Only map actual files because the index offsets of other file objects need not be file offsets.
+                tarFileObject = getattr(self, 'tarFileObject', None)
+                if isinstance(tarFileObject, (io.BufferedReader, io.FileIO)) and not self.compression:
+                    try:
+                        self.tarFileMap = mmap.mmap(tarFileObject.fileno(), 0, access=mmap.ACCESS_READ)
+                        self.tarFileMapIsSupported = True
+                    except (ValueError, OSError, OverflowError):
+                        # E.g., empty files can't be mapped.
+                        pass
+        return self.tarFileMap
+
+    def _tarFileMapIsBacked(self, tarFileMap: mmap.mmap, end: int) -> bool:
+        """
+        Returns true if the memory map can be sliced up to the given end offset. If the TAR file was truncated after
+        it had been mapped, then accessing the parts of the map beyond the new file end results in SIGBUS instead of
+        an exception. Therefore, the end is checked against the current file size, which costs one fstat call.
+        """
+        try:
+            return min(end, len(tarFileMap)) <= os.fstat(self.tarFileObject.fileno()).st_size
+        except (OSError, ValueError):
+            return False
+
+    def _withBlockCache(self, fileObject: Any) -> Any:
+        # Uncompressed TARs already profit from the operating system's page cache.
+        if not self.blockCache or not self.compression:
+            return fileObject
+        # All file objects returned by _openTarFileObject show the same data, so they can share cached blocks.
+        return BlockCachedFile(fileObject, self.blockCache, self.tarFileName, self.blockPrefetcher)
+
+    @staticmethod
+    def _initializeSqlDb(indexFileName: Optional[str], compactIndex: bool = False) -> sqlite3.Connection:
         if printDebug >= 1:
             print("Creating new SQLite index database at", indexFileName)
 
-        createTables = """
+        createFilesTable = """
             CREATE TABLE "files" (
                 "path"          VARCHAR(65535) NOT NULL,
                 "name"          VARCHAR(65535) NOT NULL,
@@ -649,6 +3111,40 @@ class SQLiteIndexedTar:
                  * the offsetheader column to the primary key. */
                 PRIMARY KEY (path,name,offsetheader)
             );
+        """
+
+        # Instead of repeating the full parent path in each row, the paths are interned into the "directories" table.
+        # WITHOUT ROWID stores the rows directly in the primary key B-tree instead of in an additional index.
+        # The "files" view provides the same columns as the "files" table for all read accesses.
+        createCompactFilesTables = """
+            CREATE TABLE "directories" (
+                "id"            INTEGER PRIMARY KEY,
+                "path"          VARCHAR(65535) NOT NULL UNIQUE
+            );
+            CREATE TABLE "compactfiles" (
+                "dirid"         INTEGER NOT NULL,  /* id of the parent path in the "directories" table */
+                "name"          VARCHAR(65535) NOT NULL,
+                "offsetheader"  INTEGER,
+                "offset"        INTEGER,
+                "size"          INTEGER,
+                "mtime"         INTEGER,
+                "mode"          INTEGER,
+                "type"          INTEGER,
+                "linkname"      VARCHAR(65535),
+                "uid"           INTEGER,
+                "gid"           INTEGER,
+                "istar"         BOOL   ,
+                "issparse"      BOOL   ,
+                PRIMARY KEY (dirid,name,offsetheader)
+            ) WITHOUT ROWID;
+            CREATE VIEW "files" AS
+                SELECT "directories"."path" AS "path", "compactfiles"."name" AS "name",
+                       "offsetheader", "offset", "size", "mtime", "mode", "type", "linkname", "uid", "gid",
+                       "istar", "issparse"
+                FROM "compactfiles" JOIN "directories" ON "compactfiles"."dirid" == "directories"."id";
+        """
+
+        createTables = """
             /* "A table created using CREATE TABLE AS has no PRIMARY KEY and no constraints of any kind"
              * Therefore, it will not be sorted and inserting will be faster! */
             CREATE TABLE "filestmp" AS SELECT * FROM "files" WHERE 0;
@@ -657,16 +3153,24 @@ class SQLiteIndexedTar:
                 "name"     VARCHAR(65535) NOT NULL,
                 PRIMARY KEY (path,name)
             );
+            /* The data blocks of sparse files. Everything in between is a hole filled with zeros. */
+            CREATE TABLE "sparseblocks" (
+                "offsetheader"  INTEGER,  /* same as in the "files" table */
+                "offset"        INTEGER,  /* offset of the block inside the expanded file */
+                "dataoffset"    INTEGER,  /* seek offset from TAR file where the block's contents reside */
+                "size"          INTEGER,
+                PRIMARY KEY (offsetheader,offset)
+            );
         """
 
         sqlConnection = SQLiteIndexedTar._openSqlDb(indexFileName if indexFileName else ':memory:')
         tables = sqlConnection.execute('SELECT name FROM sqlite_master WHERE type = "table";')
-        if {"files", "filestmp", "parentfolders"}.intersection({t[0] for t in tables}):
+        if {"files", "compactfiles", "filestmp", "parentfolders"}.intersection({t[0] for t in tables}):
             raise InvalidIndexError(
                 "The index file {} already seems to contain a table. "
                 "Please specify --recreate-index.".format(indexFileName)
             )
-        sqlConnection.executescript(createTables)
+        sqlConnection.executescript((createCompactFilesTables if compactIndex else createFilesTable) + createTables)
         return sqlConnection
 
     @staticmethod
@@ -702,15 +3206,29 @@ class SQLiteIndexedTar:
         except Exception:
             pass
 
+    def _readToEnd(self, fileObject: Any, progressBar: Any) -> int:
+        """
+        Reads the decompressor file object from the current position to the end and returns the decompressed size.
+        Unfortunately, indexed_gzip does not support io.SEEK_END even though it could as it has the index ...
+        """
+        while fileObject.read(1024 * 1024):
+            self._updateProgressBar(progressBar, fileObject)
+        return fileObject.tell()
+
     def _createIndex(
         self,
         # fmt: off
         fileObject  : Any,
         progressBar : Any = None,
         pathPrefix  : str = '',
-        streamOffset: int = 0
+        streamOffset: int = 0,
+        appendToIndex: bool = False,
         # fmt: on
     ) -> None:
+        """
+        appendToIndex : If true, the members read from fileObject are added to the already loaded index instead of
+                        creating a new one. See _appendToIndex.
+        """
         if printDebug >= 1:
             print(
                 "Creating offset dictionary for",
@@ -721,31 +3239,60 @@ class SQLiteIndexedTar:
 
         # 1. If no SQL connection was given (by recursive call), open a new database file
         openedConnection = False
-        if not self.indexIsLoaded() or not self.sqlConnection:
+        if appendToIndex and self.sqlConnection:
+            # The temporary tables also mark the index as incomplete until all new members have been added.
+            openedConnection = True
+            self.sqlConnection.executescript(
+                """
+                CREATE TABLE "filestmp" AS SELECT * FROM "files" WHERE 0;
+                CREATE TABLE "parentfolders" (
+                    "path"     VARCHAR(65535) NOT NULL,
+                    "name"     VARCHAR(65535) NOT NULL,
+                    PRIMARY KEY (path,name)
+                );
+                """
+            )
+        elif not self.indexIsLoaded() or not self.sqlConnection:
             openedConnection = True
-            self.sqlConnection = self._initializeSqlDb(self.indexFileName)
+            self.sqlConnection = self._initializeSqlDb(self.indexFileName, self.compactIndex)
+            if self.inlineFileSizeLimit > 0:
+                self.sqlConnection.executescript(
+                    """
+                    CREATE TABLE "inlinefiles" (
+                        "offsetheader"  INTEGER PRIMARY KEY,  /* same as in the "files" table */
+                        "data"          BLOB
+                    );
+                    """
+                )
+                self.hasInlineFiles = True
+                self.indexInlineFileSizeLimit = self.inlineFileSizeLimit
+            self.hasSparseBlocks = True
 
         # 2. Open TAR file reader
         loadedTarFile: Any = []  # Feign an empty TAR file if anything goes wrong
         if self.isTar:
             try:
-                # r: uses seeks to skip to the next file inside the TAR while r| doesn't do any seeks.
-                # r| might be slower but for compressed files we have to go over all the data once anyways.
+                # Behaves like tarfile.open with 'r:' but skips most of the TarInfo overhead. For compressed files,
+                # it only seeks forward, so that the decompressor skips over the file contents instead of copying
+                # them like tarfile in 'r|' mode while implicitly collecting the seek points or block offsets.
                 # Note that with ignore_zeros = True, no invalid header issues or similar will be raised even for
                 # non TAR files!?
-                loadedTarFile = tarfile.open(
+                loadedTarFile = TarHeaderScanner(
                     # fmt:off
-                    fileobj      = fileObject,
-                    mode         = 'r|' if self.compression else 'r:',
-                    ignore_zeros = self.ignoreZeros,
-                    encoding     = self.encoding,
+                    fileObject,
+                    encoding    = self.encoding,
+                    ignoreZeros = self.ignoreZeros,
+                    streaming   = bool(self.compression),
                     # fmt:on
                 )
             except tarfile.ReadError:
                 pass
 
         if progressBar is None:
-            progressBar = ProgressBar(os.fstat(fileObject.fileno()).st_size)
+            if len(self.tarFileParts) > 1 or isRemotePath(self.tarFileName):
+                progressBar = ProgressBar(sum(statPath(part).st_size for part in self.tarFileParts))
+            else:
+                progressBar = ProgressBar(os.fstat(fileObject.fileno()).st_size)
 
         # 3. Iterate over files inside TAR and add them to the database
         try:
@@ -779,10 +3326,23 @@ class SQLiteIndexedTar:
                 )
                 # fmt: on
 
+                if tarInfo.issparse():
+                    self._storeSparseBlocks(fileInfo[2], fileInfo[3], tarInfo.sparse)
+
+                if streamOffset == 0 and isinstance(loadedTarFile, TarHeaderScanner):
+                    self.tarAppendInfo = (tarInfo.offset, loadedTarFile.tell())
+
                 if self.mountRecursively and tarInfo.isfile() and tarInfo.name.lower().endswith('.tar'):
                     filesToMountRecursively.append(fileInfo)
                 else:
                     self._setFileInfo(fileInfo)
+                    if (
+                        self.hasInlineFiles
+                        and tarInfo.isfile()
+                        and not tarInfo.issparse()
+                        and 0 < tarInfo.size <= self.inlineFileSizeLimit
+                    ):
+                        self._storeInlineFile(fileInfo[2], loadedTarFile.extractfile(tarInfo))
         except tarfile.ReadError as e:
             if 'unexpected end of data' in str(e):
                 print(
@@ -793,6 +3353,8 @@ class SQLiteIndexedTar:
         # 4. Open contained TARs for recursive mounting
         oldPos = fileObject.tell()
         oldPrintName = self.tarFileName
+
+        nestedTarMountPaths = []
         for fileInfo in filesToMountRecursively:
             tarExtension = '.tar'
             fullPath = os.path.join(fileInfo[0], fileInfo[1])
@@ -801,28 +3363,49 @@ class SQLiteIndexedTar:
                 and len(tarExtension) > 0
                 and fullPath.lower().endswith(tarExtension.lower())
             ):
-                modifiedFullPath = fullPath[: -len(tarExtension)]
+                nestedTarMountPaths.append(fullPath[: -len(tarExtension)])
             else:
-                modifiedFullPath = fullPath
-
-            # Temporarily change tarFileName for the info output of the recursive call
-            self.tarFileName = fullPath
+                nestedTarMountPaths.append(fullPath)
 
-            # StenciledFile's tell returns the offset inside the file chunk instead of the global one,
-            # so we have to always communicate the offset of this chunk to the recursive call no matter
-            # whether tarfile has streaming access or seeking access!
-            globalOffset = fileInfo[3]
-            size = fileInfo[4]
-            tarFileObject = StenciledFile(fileObject, [(globalOffset, size)])
+        # Nested TARs inside an uncompressed TAR can be read independently of each other from the TAR file,
+        # so they are indexed in parallel processes and the results inserted in the same order as if done serially.
+        nestedIndexes: Dict[int, Optional[Tuple[list, list, list, list]]] = {}
+        if (
+            self.parallelization != 1
+            and streamOffset == 0
+            and not self.compression
+            and len(filesToMountRecursively) > 1
+            and os.path.isfile(self.tarFileName)
+        ):
+            nestedIndexes = self._createNestedIndexesInParallel(
+                filesToMountRecursively, nestedTarMountPaths, progressBar
+            )
 
+        for fileInfo, modifiedFullPath in zip(filesToMountRecursively, nestedTarMountPaths):
             isTar = False
-            try:
-                self._createIndex(tarFileObject, progressBar, modifiedFullPath, globalOffset)
-                isTar = True
-            except tarfile.ReadError:
-                pass
-            finally:
-                del tarFileObject
+            if fileInfo[2] in nestedIndexes:
+                nestedIndex = nestedIndexes[fileInfo[2]]
+                if nestedIndex:
+                    self._insertNestedIndex(*nestedIndex)
+                    isTar = True
+            else:
+                # Temporarily change tarFileName for the info output of the recursive call
+                self.tarFileName = os.path.join(fileInfo[0], fileInfo[1])
+
+                # StenciledFile's tell returns the offset inside the file chunk instead of the global one,
+                # so we have to always communicate the offset of this chunk to the recursive call no matter
+                # whether tarfile has streaming access or seeking access!
+                globalOffset = fileInfo[3]
+                size = fileInfo[4]
+                tarFileObject = StenciledFile(fileObject, [(globalOffset, size)])
+
+                try:
+                    self._createIndex(tarFileObject, progressBar, modifiedFullPath, globalOffset)
+                    isTar = True
+                except tarfile.ReadError:
+                    pass
+                finally:
+                    del tarFileObject
 
             if isTar:
                 modifiedFileInfo = list(fileInfo)
@@ -862,24 +3445,34 @@ class SQLiteIndexedTar:
                 )
             return
 
+        # Decode the rest of a compressed file, e.g., the zero padding after the TAR, in the same pass as the headers.
+        # This completes the seek points or block offsets implicitly collected by the decompressor, so that
+        # _loadOrStoreCompressionOffsets does not have to decode anything anymore, and yields the decompressed size.
+        decompressedSize = self._readToEnd(fileObject, progressBar) if self.compression else None
+
         # If no file is in the TAR, then it most likely indicates a possibly compressed non TAR file.
         # In that case add that itself to the file index. This won't work when called recursively,
         # so check stream offset.
+        self._flushFileInfos()
         fileCount = self.sqlConnection.execute('SELECT COUNT(*) FROM "files";').fetchone()[0]
         if fileCount == 0:
-            tarInfo = os.fstat(fileObject.fileno())
+            if len(self.tarFileParts) > 1 or isRemotePath(self.tarFileName):
+                tarInfo = statPath(self.tarFileParts[0])
+            else:
+                tarInfo = os.fstat(fileObject.fileno())
             fname = os.path.basename(self.tarFileName)
+            if isRemotePath(self.tarFileName):
+                fname = os.path.basename(urllib.parse.urlsplit(self.tarFileName).path)
+            if len(self.tarFileParts) > 1:
+                fname = os.path.splitext(fname)[0]
             for suffix in ['.gz', '.bz2', '.bzip2', '.gzip', '.xz', '.zst', '.zstd']:
                 if fname.lower().endswith(suffix) and len(fname) > len(suffix):
                     fname = fname[: -len(suffix)]
                     break
 
             # If the file object is actually an IndexedBzip2File or such, we can't directly use the file size
-            # from os.stat and instead have to gather it from seek. Unfortunately, indexed_gzip does not support
-            # io.SEEK_END even though it could as it has the index ...
-            while fileObject.read(1024 * 1024):
-                self._updateProgressBar(progressBar, fileObject)
-            fileSize = fileObject.tell()
+            # from os.stat and instead have to gather it by decoding everything, which was done above.
+            fileSize = fileObject.seek(0, io.SEEK_END) if decompressedSize is None else decompressedSize
 
             # fmt: off
             fileInfo = (
@@ -904,6 +3497,8 @@ class SQLiteIndexedTar:
         if not openedConnection:
             return
 
+        self._flushFileInfos()
+
         # 5. Resort by (path,name). This one-time resort is faster than resorting on each INSERT (cache spill)
         if printDebug >= 2:
             print("Resorting files by path ...")
@@ -919,6 +3514,20 @@ class SQLiteIndexedTar:
         """.format(
             int(0o555 | stat.S_IFDIR), int(tarfile.DIRTYPE)
         )
+        # The rows are inserted directly into "compactfiles" by _flushFileInfos, so "filestmp" is always empty.
+        if self.compactIndex:
+            cleanupDatabase = """
+                DROP TABLE "filestmp";
+                INSERT OR IGNORE INTO "directories" ("path") SELECT DISTINCT path FROM "parentfolders";
+                INSERT OR IGNORE INTO "compactfiles"
+                    /* dirid name offsetheader offset size mtime mode type linkname uid gid istar issparse */
+                    SELECT "directories"."id","parentfolders"."name",0,0,1,0,{},{},"",0,0,0,0
+                    FROM "parentfolders" JOIN "directories" ON "parentfolders"."path" == "directories"."path"
+                    ORDER BY "directories"."id","parentfolders"."name";
+                DROP TABLE "parentfolders";
+            """.format(
+                int(0o555 | stat.S_IFDIR), int(tarfile.DIRTYPE)
+            )
         self.sqlConnection.executescript(cleanupDatabase)
 
         self.sqlConnection.commit()
@@ -931,6 +3540,122 @@ class SQLiteIndexedTar:
                 "took {:.2f}s".format(t1 - t0),
             )
 
+    def _createNestedIndexesInParallel(
+        self, fileInfos: List[tuple], mountPaths: List[str], progressBar: Any
+    ) -> Dict[int, Optional[Tuple[list, list, list, list]]]:
+        """
+        Indexes the nested TARs specified by the file info rows in parallel processes and returns the results
+        of _createNestedIndex for each of them keyed by their header offset.
+        """
+        # Only forward the options, which influence the index. The others might not even be picklable.
+        # fmt: off
+        arguments = dict(
+            recursive                  = self.mountRecursively,
+            encoding                   = self.encoding,
+            stripRecursiveTarExtension = self.stripRecursiveTarExtension,
+            ignoreZeros                = self.ignoreZeros,
+            inlineFileSizeLimit        = self.inlineFileSizeLimit,
+        )
+        # fmt: on
+        maxWorkers = self.parallelization if self.parallelization > 0 else os.cpu_count()
+        results: Dict[int, Optional[Tuple[list, list, list, list]]] = {}
+        with concurrent.futures.ProcessPoolExecutor(
+            max_workers=maxWorkers, initializer=_initializeIndexingWorker, initargs=(printDebug,)
+        ) as executor:
+            futures = {
+                executor.submit(
+                    SQLiteIndexedTar._createNestedIndex,
+                    self.tarFileParts,
+                    fileInfo[3],
+                    fileInfo[4],
+                    mountPath,
+                    arguments,
+                ): fileInfo
+                for fileInfo, mountPath in zip(fileInfos, mountPaths)
+            }
+
+            indexedSize = 0
+            for future in concurrent.futures.as_completed(futures):
+                fileInfo = futures[future]
+                results[fileInfo[2]] = future.result()
+                indexedSize += fileInfo[4]
+                progressBar.update(indexedSize)
+
+        return results
+
+    @staticmethod
+    def _createNestedIndex(
+        tarFileParts: List[str], offset: int, size: int, pathPrefix: str, arguments: Dict[str, Any]
+    ) -> Optional[Tuple[list, list, list, list]]:
+        """
+        Indexes the uncompressed nested TAR at the given offset and size inside the TAR file into an in-memory
+        database and returns the rows for the "files", "parentfolders", "inlinefiles", and "sparseblocks" tables,
+        or None if it is not a TAR. It is run in worker processes, which can't open the whole TAR, and therefore
+        only initializes the members and then sets what the constructor would have detected for the TAR.
+        """
+        indexer = SQLiteIndexedTar.__new__(SQLiteIndexedTar)
+        indexer._initializeMembers(**arguments)
+        # fmt: off
+        indexer.tarFileName   = os.path.join(tarFileParts[0], pathPrefix.lstrip('/'))
+        indexer.tarFileParts  = tarFileParts
+        indexer.rawFileObject = None
+        indexer.compression   = None
+        indexer.isTar         = True
+        # fmt: on
+
+        with SQLiteIndexedTar._openTarFileParts(tarFileParts) as file:
+            try:
+                indexer._createIndex(StenciledFile(file, [(offset, size)]), ProgressBar(size), pathPrefix, offset)
+            except tarfile.ReadError:
+                return None
+
+        indexer._flushFileInfos()
+        assert indexer.sqlConnection
+        connection = indexer.sqlConnection
+        return (
+            [tuple(row) for row in connection.execute('SELECT * FROM "files";')],
+            [tuple(row) for row in connection.execute('SELECT * FROM "parentfolders";')],
+            [tuple(row) for row in connection.execute('SELECT * FROM "inlinefiles";')]
+            if indexer.hasInlineFiles
+            else [],
+            [tuple(row) for row in connection.execute('SELECT * FROM "sparseblocks";')],
+        )
+
+    def _insertNestedIndex(
+        self, fileInfos: List[tuple], parentFolders: List[tuple], inlineFiles: List[tuple], sparseBlocks: List[tuple]
+    ) -> None:
+        """Inserts the rows returned by _createNestedIndex into the index."""
+        if not self.sqlConnection:
+            raise IndexNotOpenError("This method can not be called without an opened index database!")
+
+        self.fileInfosToInsert.extend(fileInfos)
+        self.parentFoldersToInsert.extend(parentFolders)
+        self._flushFileInfos()
+        if inlineFiles and self.hasInlineFiles:
+            self.sqlConnection.executemany('INSERT OR REPLACE INTO "inlinefiles" VALUES (?,?)', inlineFiles)
+        if sparseBlocks:
+            self.sqlConnection.executemany('INSERT OR REPLACE INTO "sparseblocks" VALUES (?,?,?,?)', sparseBlocks)
+
+    def _storeSparseBlocks(self, offsetheader: int, offset: int, sparse: List[Tuple[int, int]]) -> None:
+        """Stores the sparse map as returned by tarfile. The data of all blocks is stored consecutively at offset."""
+        if not self.sqlConnection:
+            raise IndexNotOpenError("This method can not be called without an opened index database!")
+
+        rows = []
+        for blockOffset, blockSize in sparse:
+            if blockSize > 0:
+                rows.append((offsetheader, blockOffset, offset, blockSize))
+            offset += blockSize
+        self.sqlConnection.executemany('INSERT OR REPLACE INTO "sparseblocks" VALUES (?,?,?,?)', rows)
+
+    def _storeInlineFile(self, offsetheader: int, fileObject: Optional[IO[bytes]]) -> None:
+        if not self.sqlConnection:
+            raise IndexNotOpenError("This method can not be called without an opened index database!")
+        if fileObject:
+            self.sqlConnection.execute(
+                'INSERT OR REPLACE INTO "inlinefiles" VALUES (?,?)', (offsetheader, fileObject.read())
+            )
+
     @staticmethod
     def _rowToFileInfo(row: Dict[str, Any]) -> FileInfo:
         return FileInfo(
@@ -979,22 +3704,45 @@ class SQLiteIndexedTar:
 
         If listVersions is true, then return metadata for all versions of a file possibly appearing more than once
         in the TAR as a directory dictionary. listDir will then be ignored!
-        """
-        # TODO cache last listDir as most often a stat over all entries will soon follow
 
+        The directory dictionaries returned for listDir=True may be cached and therefore must not be modified.
+        """
         if not isinstance(fileVersion, int):
             raise TypeError("The specified file version must be an integer!")
-        if not self.sqlConnection:
-            raise IndexNotOpenError("This method can not be called without an opened index database!")
 
         # also strips trailing '/' except for a single '/' and leading '/'
         fullPath = '/' + os.path.normpath(fullPath).lstrip('/')
 
+        if not listVersions:
+            cachedResult = self._getCachedFileInfo(fullPath, listDir, fileVersion)
+            if cachedResult is not None:
+                performanceStatistics.count('index.directoryCache.hits')
+                return cachedResult
+            performanceStatistics.count('index.directoryCache.misses')
+
+        startTime = timer()
+        with self._sqlConnectionForReading() as connection:
+            result = self._getFileInfo(connection, fullPath, listDir, listVersions, fileVersion)
+        queryName = 'listVersions' if listVersions else 'listDir' if listDir else 'getFileInfo'
+        performanceStatistics.addLatency('index.sqlite.' + queryName, timer() - startTime)
+        return result
+
+    def _getFileInfo(
+        self,
+        # fmt: off
+        connection   : sqlite3.Connection,
+        fullPath     : str,
+        listDir      : bool,
+        listVersions : bool,
+        fileVersion  : int
+        # fmt: on
+    ) -> Optional[Union[FileInfo, Dict[str, FileInfo]]]:
+        """The arguments are the same as for getFileInfo but fullPath must already be normalized."""
+        # For the compact index, SQLite resolves the "path" condition on the "files" view with the unique index of
+        # the "directories" table and then searches the primary key of "compactfiles" with the found id.
         if listVersions:
             path, name = fullPath.rsplit('/', 1)
-            rows = self.sqlConnection.execute(
-                'SELECT * FROM "files" WHERE "path" == (?) AND "name" == (?) ORDER BY "offsetheader" ASC', (path, name)
-            )
+            rows = connection.execute(self._fileVersionsQuery, (path, name))
             result = {str(version + 1): self._rowToFileInfo(row) for version, row in enumerate(rows)}
             return result
 
@@ -1005,29 +3753,53 @@ class SQLiteIndexedTar:
             # Or, are folders assumed to be overwritten by a new folder entry in a TAR or should they be union mounted?
             # If they should be union mounted, like is the case now, then the folder version only makes sense for
             # its attributes.
-            rows = self.sqlConnection.execute('SELECT * FROM "files" WHERE "path" == (?)', (fullPath.rstrip('/'),))
-            directory = {}
+            rows = connection.execute(self._directoryQuery, (fullPath.rstrip('/'),))
+            directory: Dict[str, FileInfo] = {}
             gotResults = False
             for row in rows:
                 gotResults = True
                 if row['name']:
-                    directory[row['name']] = self._rowToFileInfo(row)
-            return directory if gotResults else None
+                    # Keep the most recent version like getFileInfo does for fileVersion=0.
+                    fileInfo = self._rowToFileInfo(row)
+                    oldFileInfo = directory.get(row['name'])
+                    if not oldFileInfo or fileInfo.offsetheader >= oldFileInfo.offsetheader:
+                        directory[row['name']] = fileInfo
+            if not gotResults:
+                return None
+
+            with self.directoryCacheLock:
+                self.directoryCache[fullPath.rstrip('/')] = directory
+                while len(self.directoryCache) > self.directoryCacheSize:
+                    self.directoryCache.popitem(last=False)
+            return directory
 
         path, name = fullPath.rsplit('/', 1)
-        row = self.sqlConnection.execute(
-            """
-            SELECT * FROM "files"
-            WHERE "path" == (?) AND "name" == (?)
-            ORDER BY "offsetheader" {}
-            LIMIT 1 OFFSET (?);
-            """.format(
-                'DESC' if fileVersion is None or fileVersion <= 0 else 'ASC'
-            ),
+        row = connection.execute(
+            self._fileInfoQueries['DESC' if fileVersion is None or fileVersion <= 0 else 'ASC'],
             (path, name, 0 if fileVersion is None else fileVersion - 1 if fileVersion > 0 else fileVersion),
         ).fetchone()
         return self._rowToFileInfo(row) if row else None
 
+    def _getCachedFileInfo(
+        self, fullPath: str, listDir: bool, fileVersion: int
+    ) -> Optional[Union[FileInfo, Dict[str, FileInfo]]]:
+        """
+        Returns the result for getFileInfo from the recently listed directories or None if it is not cached.
+        Only the most recent file versions can be answered from the cache. fullPath must already be normalized.
+        """
+        with self.directoryCacheLock:
+            if listDir:
+                directory = self.directoryCache.get(fullPath.rstrip('/'))
+                if directory is not None:
+                    self.directoryCache.move_to_end(fullPath.rstrip('/'))
+                return directory
+
+            if fileVersion != 0:
+                return None
+            path, name = fullPath.rsplit('/', 1)
+            directory = self.directoryCache.get(path)
+            return directory.get(name) if directory and name else None
+
     def isDir(self, path: str) -> bool:
         """Return true if path exists and is a folder."""
         return isinstance(self.getFileInfo(path, listDir=True), dict)
@@ -1065,25 +3837,423 @@ class SQLiteIndexedTar:
             if targetLink != path:
                 return self.read(targetLink, size, offset)
 
-        if not fileInfo.issparse:
-            # For non-sparse files, we can simply seek to the offset and read from it.
-            self.tarFileObject.seek(fileInfo.offset + offset, os.SEEK_SET)
-            return self.tarFileObject.read(size)
-
-        # The TAR file format is very simple. It's just a concatenation of TAR blocks. There is not even a
-        # global header, only the TAR block headers. That's why we can simply cut out the TAR block for
-        # the sparse file using StenciledFile and then use tarfile on it to expand the sparse file correctly.
-        tarBlockSize = fileInfo.offset - fileInfo.offsetheader + fileInfo.size
-        tarSubFile = StenciledFile(self.tarFileObject, [(fileInfo.offsetheader, tarBlockSize)])
-        with tarfile.open(fileobj=typing.cast(BinaryIO, tarSubFile), mode='r:', encoding=self.encoding) as tmpTarFile:
-            tmpFileObject = tmpTarFile.extractfile(next(iter(tmpTarFile)))
-            if tmpFileObject:
-                tmpFileObject.seek(offset, os.SEEK_SET)
-                result = tmpFileObject.read(size)
-            else:
-                print("tarfile.extractfile returned nothing!")
-                raise fuse.FuseOSError(fuse.errno.EIO)
-        return result
+        inlineData = self._readInlineFile(fileInfo)
+        if inlineData is not None:
+            return inlineData[offset : offset + size]
+
+        if self.gzipDenseSeekPointSpacing > 0 and self.compression == 'gz':
+            self._countGzipRead(fileInfo.offset + offset, size)
+
+        if fileInfo.issparse and self.hasSparseBlocks:
+            return self._readSparse(fileInfo, size, offset)
+
+        if not fileInfo.issparse:
+            # Slicing the memory map needs neither a seek nor a lock and the page cache does the buffering.
+            tarFileMap = self._tarFileMapForReading()
+            end = fileInfo.offset + offset + size
+            if tarFileMap is not None and self._tarFileMapIsBacked(tarFileMap, end):
+                return tarFileMap[fileInfo.offset + offset : end]
+
+        with self._tarFileObjectForReading() as tarFileObject:
+            if not fileInfo.issparse:
+                # For non-sparse files, we can simply seek to the offset and read from it.
+                if self.compression:
+                    self._recordDecoderRead(tarFileObject, fileInfo.offset + offset, size)
+                tarFileObject.seek(fileInfo.offset + offset, os.SEEK_SET)
+                return tarFileObject.read(size)
+
+            # The TAR file format is very simple. It's just a concatenation of TAR blocks. There is not even a
+            # global header, only the TAR block headers. That's why we can simply cut out the TAR block for
+            # the sparse file using StenciledFile and then use tarfile on it to expand the sparse file correctly.
+            tarBlockSize = fileInfo.offset - fileInfo.offsetheader + fileInfo.size
+            tarSubFile = StenciledFile(tarFileObject, [(fileInfo.offsetheader, tarBlockSize)])
+            with tarfile.open(
+                fileobj=typing.cast(BinaryIO, tarSubFile), mode='r:', encoding=self.encoding
+            ) as tmpTarFile:
+                tmpFileObject = tmpTarFile.extractfile(next(iter(tmpTarFile)))
+                if tmpFileObject:
+                    tmpFileObject.seek(offset, os.SEEK_SET)
+                    result = tmpFileObject.read(size)
+                else:
+                    print("tarfile.extractfile returned nothing!")
+                    raise fuse.FuseOSError(fuse.errno.EIO)
+            return result
+
+    def _recordDecoderRead(self, fileObject: Any, offset: int, size: int) -> None:
+        """
+        Records the seek distance of the decompressor for a read at the given decompressed offset and an estimate of
+        the bytes it has to decode for it, i.e., from the current position or the last seek point before offset.
+        The estimate is skipped for the block cache, whose hit rate shows how much decoding it saves.
+        """
+        position = fileObject.tell()
+        counts = {'decoder.reads': 1, 'decoder.bytesRequested': size}
+        if position != offset:
+            counts['decoder.seeks'] = 1
+            counts['decoder.seekDistance'] = abs(offset - position)
+
+        if not isinstance(fileObject, BlockCachedFile):
+            # Sequential reads, the most frequent case, continue decoding right at the offset without a seek point.
+            restartOffset = position if position <= offset else 0
+            compressionBlocks = self._getCompressionBlocks() if position != offset else None
+            if compressionBlocks:
+                decompressedOffsets = compressionBlocks[0]
+                seekPoint = decompressedOffsets[max(0, bisect.bisect_right(decompressedOffsets, offset) - 1)]
+                if seekPoint <= offset:
+                    restartOffset = max(restartOffset, seekPoint)
+            counts['decoder.bytesDecoded'] = offset - restartOffset + size
+
+        performanceStatistics.countMany(counts)
+
+    def _readInlineFile(self, fileInfo: FileInfo) -> Optional[bytes]:
+        """Returns the contents of the file if they are stored in the index, see inlineFileSizeLimit."""
+        if not self.hasInlineFiles or fileInfo.issparse or not 0 < fileInfo.size <= self.indexInlineFileSizeLimit:
+            return None
+        with self._sqlConnectionForReading() as connection:
+            row = connection.execute(
+                'SELECT data FROM "inlinefiles" WHERE "offsetheader" == (?);', (fileInfo.offsetheader,)
+            ).fetchone()
+        if row:
+            performanceStatistics.count('index.inlineFileReads')
+        return row[0] if row else None
+
+    def readFiles(self, paths: Iterable[str], chunkSize: int = 1024 * 1024) -> Iterator[Tuple[str, int, bytes]]:
+        """
+        Reads all given files in one forward pass over the archive sorted by their offset in it instead of in the
+        given order, which would require a costly backward seek for each file in compressed archives.
+        Yields tuples (path, offset inside the file, data) with chunks of at most chunkSize bytes. Each file yields
+        at least one chunk, which is empty for empty files. Duplicate paths are only read once.
+        Raises a ValueError before reading anything if any path does not exist or is not a file.
+        """
+        requests = []
+        for path in dict.fromkeys(paths):
+            fileInfo = self.getFileInfo(path)
+            # Dereference hard links
+            targetLink = path
+            while (
+                isinstance(fileInfo, FileInfo)
+                and not stat.S_ISREG(fileInfo.mode)
+                and not stat.S_ISLNK(fileInfo.mode)
+                and fileInfo.linkname
+                and '/' + fileInfo.linkname.lstrip('/') != targetLink
+            ):
+                targetLink = '/' + fileInfo.linkname.lstrip('/')
+                fileInfo = self.getFileInfo(targetLink)
+            if not isinstance(fileInfo, FileInfo) or stat.S_ISDIR(fileInfo.mode) or stat.S_ISLNK(fileInfo.mode):
+                raise ValueError("Specified path '{}' is not a file that can be read!".format(path))
+            requests.append((path, fileInfo))
+        requests.sort(key=lambda request: request[1].offset)
+
+        with self._tarFileObjectForReading() as tarFileObject:
+            for path, fileInfo in requests:
+                data = self._readInlineFile(fileInfo)
+                if data is not None or fileInfo.issparse:
+                    for offset in range(0, max(1, fileInfo.size), chunkSize):
+                        yield path, offset, (
+                            data[offset : offset + chunkSize]
+                            if data is not None
+                            else self.read(path, min(chunkSize, fileInfo.size - offset), offset, fileInfo)
+                        )
+                    continue
+
+                # Decode small gaps, e.g., TAR headers and skipped files, instead of seeking inside compressed TARs.
+                gap = fileInfo.offset - tarFileObject.tell()
+                if self.compression and 0 <= gap <= self.bulkReadMaxSkipSize:
+                    while gap > 0:
+                        gap -= len(tarFileObject.read(min(gap, chunkSize))) or gap
+                else:
+                    tarFileObject.seek(fileInfo.offset)
+
+                for offset in range(0, max(1, fileInfo.size), chunkSize):
+                    yield path, offset, tarFileObject.read(min(chunkSize, fileInfo.size - offset))
+
+    def _getSparseBlocks(self, offsetheader: int) -> Tuple[List[int], List[tuple]]:
+        """Returns the expanded offsets and the rows of the "sparseblocks" table for the given sparse file."""
+        with self.sparseBlocksCacheLock:
+            if offsetheader in self.sparseBlocksCache:
+                self.sparseBlocksCache.move_to_end(offsetheader)
+                return self.sparseBlocksCache[offsetheader]
+
+        with self._sqlConnectionForReading() as connection:
+            blocks = connection.execute(
+                'SELECT "offset", "dataoffset", "size" FROM "sparseblocks" WHERE "offsetheader" == (?) '
+                'ORDER BY "offset" ASC;',
+                (offsetheader,),
+            ).fetchall()
+        result = ([block[0] for block in blocks], [tuple(block) for block in blocks])
+
+        with self.sparseBlocksCacheLock:
+            self.sparseBlocksCache[offsetheader] = result
+            while len(self.sparseBlocksCache) > self.sparseBlocksCacheSize:
+                self.sparseBlocksCache.popitem(last=False)
+        return result
+
+    def _readSparse(self, fileInfo: FileInfo, size: int, offset: int) -> bytes:
+        """Reads from a sparse file using its stored sparse map. Holes are returned as zeros without any reads."""
+        size = max(0, min(size, fileInfo.size - offset))
+        end = offset + size
+        offsets, blocks = self._getSparseBlocks(fileInfo.offsetheader)
+
+        # The parts to read as tuples (offset in the result, offset in the TAR, size)
+        chunks = []
+        for blockOffset, dataOffset, blockSize in blocks[max(0, bisect.bisect_right(offsets, offset) - 1) :]:
+            if blockOffset >= end:
+                break
+            chunkBegin = max(offset, blockOffset)
+            chunkEnd = min(end, blockOffset + blockSize)
+            if chunkBegin < chunkEnd:
+                chunks.append((chunkBegin - offset, dataOffset + chunkBegin - blockOffset, chunkEnd - chunkBegin))
+
+        result = bytearray(size)
+        if not chunks:
+            return bytes(result)
+
+        tarFileMap = self._tarFileMapForReading()
+        if tarFileMap is not None and self._tarFileMapIsBacked(tarFileMap, max(o + n for _, o, n in chunks)):
+            for resultOffset, dataOffset, chunkSize in chunks:
+                data = tarFileMap[dataOffset : dataOffset + chunkSize]
+                result[resultOffset : resultOffset + len(data)] = data
+            return bytes(result)
+
+        with self._tarFileObjectForReading() as tarFileObject:
+            for resultOffset, dataOffset, chunkSize in chunks:
+                tarFileObject.seek(dataOffset)
+                data = tarFileObject.read(chunkSize)
+                result[resultOffset : resultOffset + len(data)] = data
+        return bytes(result)
+
+    def _getCompressionBlocks(self) -> Optional[Tuple[List[int], List[int]]]:
+        """
+        Returns the decompressed and compressed offsets of all compression blocks or gzip seek points stored in the
+        index sorted by the decompressed offset. Returns None for uncompressed archives or if they are not known.
+        """
+        if (
+            self.compressionBlocks is not None
+            or self.compressionBlocksUnavailable
+            or self.compression not in ['bz2', 'zst', 'xz', 'gz']
+        ):
+            return self.compressionBlocks
+
+        blocks: List[Tuple[int, int]] = []
+        with self._sqlConnectionForReading() as connection:
+            try:
+                if self.compression == 'gz':
+                    index = GzipIndex.read(SQLiteBlobsFile(connection, 'gzipindex', 'data'), readWindows=False)
+                    # Seek points with bits set start inside the preceding byte.
+                    blocks = [(point[1], point[0] - (1 if point[2] else 0)) for point in index.points]
+                else:
+                    rows = connection.execute(
+                        'SELECT dataoffset,blockoffset FROM {} ORDER BY dataoffset;'.format(self._blockTableName())
+                    )
+                    # The bzip2 block offsets are in bits.
+                    blocks = [(row[0], row[1] // 8 if self.compression == 'bz2' else row[1]) for row in rows]
+            except (sqlite3.Error, ValueError, struct.error) as exception:
+                if printDebug >= 2:
+                    print("[Info] Could not load the compression block offsets because of:", exception)
+                self.compressionBlocksUnavailable = True
+                return None
+
+        if not blocks:
+            self.compressionBlocksUnavailable = True
+            return None
+        blocks.sort()
+        self.compressionBlocks = ([block[0] for block in blocks], [block[1] for block in blocks])
+        return self.compressionBlocks
+
+    def getBlockRange(self, fileInfo: FileInfo) -> Optional[BlockRange]:
+        """
+        Returns the range of compression blocks or gzip seek points spanned by the given file's data or None if the
+        archive is not compressed with bzip2, gzip, zstd, or xz. This can be used to group reads of many files by block,
+        so that each block only has to be decoded once.
+        """
+        compressionBlocks = self._getCompressionBlocks()
+        if not compressionBlocks or fileInfo.offset is None:
+            return None
+
+        decompressedOffsets, compressedOffsets = compressionBlocks
+        firstBlock = max(0, bisect.bisect_right(decompressedOffsets, fileInfo.offset) - 1)
+        lastOffset = fileInfo.offset + max(0, fileInfo.size - 1)
+        lastBlock = max(firstBlock, bisect.bisect_right(decompressedOffsets, lastOffset) - 1)
+        if lastBlock + 1 < len(compressedOffsets):
+            compressedEnd = compressedOffsets[lastBlock + 1]
+        else:
+            compressedEnd = sum(statPath(part).st_size for part in self.tarFileParts)
+        return BlockRange(
+            # fmt: off
+            firstblock       = firstBlock,
+            lastblock        = lastBlock,
+            compressedoffset = compressedOffsets[firstBlock],
+            compressedsize   = compressedEnd - compressedOffsets[firstBlock],
+            # fmt: on
+        )
+
+    def pathCount(self) -> int:
+        """Returns the number of files and folders in the index including all versions of updated files."""
+        with self._sqlConnectionForReading() as connection:
+            return connection.execute('SELECT COUNT(*) FROM "files";').fetchone()[0]
+
+    def listPaths(self) -> Iterator[str]:
+        """Yields the full paths of all files and folders in the index, e.g., '/foo/bar', in no particular order."""
+        with self._sqlConnectionForReading() as connection:
+            for path, name in connection.execute('SELECT "path","name" FROM "files";'):
+                yield path + '/' + name
+
+    def listBlockRanges(self) -> Iterator[Tuple[str, BlockRange]]:
+        """Yields the paths and block ranges of all regular files sorted by their offset in the archive."""
+        if not self._getCompressionBlocks():
+            return
+
+        with self._sqlConnectionForReading() as connection:
+            rows = connection.execute('SELECT * FROM "files" WHERE "offsetheader" IS NOT NULL ORDER BY "offset";')
+            for row in rows:
+                fileInfo = self._rowToFileInfo(row)
+                if not stat.S_ISREG(fileInfo.mode) or fileInfo.istar:
+                    continue
+                blockRange = self.getBlockRange(fileInfo)
+                if blockRange:
+                    yield row['path'] + '/' + row['name'], blockRange
+
+    def _countGzipRead(self, offset: int, size: int) -> None:
+        """
+        Counts random reads per coarse region of the decompressed TAR and schedules the densification of the seek
+        points of hot regions in a background thread, so that the read itself does not have to wait for it.
+        """
+        region = offset // max(1, self.gzipSeekPointSpacing)
+        with self.gzipDensificationLock:
+            isSequential = offset == self.gzipLastReadEnd
+            self.gzipLastReadEnd = offset + size
+            if isSequential or region in self.gzipDensifiedRegions or self.gzipDensificationClosed:
+                return
+
+            readCount = self.gzipRegionReadCounts.get(region, 0) + 1
+            if readCount < self.gzipHotRegionReadCount:
+                self.gzipRegionReadCounts[region] = readCount
+                return
+
+            self.gzipRegionReadCounts.pop(region, None)
+            self.gzipDensifiedRegions.add(region)
+            if not self.gzipDensificationExecutor:
+                self.gzipDensificationExecutor = concurrent.futures.ThreadPoolExecutor(max_workers=1)
+            self.gzipDensificationExecutor.submit(self._densifyGzipRegion, offset)
+
+    def _densifyGzipRegion(self, offset: int) -> None:
+        """Runs in the background thread started by _countGzipRead."""
+        if self.gzipDensificationClosed:
+            return
+        try:
+            self._addGzipSeekPoints(offset)
+        except Exception as exception:
+            if printDebug >= 1:
+                print("[Warning] Could not add gzip seek points around offset", offset, "because of:", exception)
+
+    def _addGzipSeekPoints(self, offset: int) -> None:
+        """
+        Adds seek points with gzipDenseSeekPointSpacing between the two existing seek points enclosing the given
+        offset into the decompressed TAR. indexed_gzip only creates seek points while extending its index, therefore
+        an index truncated after the preceding seek point is extended with the dense spacing and only the new points
+        are inserted into the stored index and into the "gzipseekpoints" table. Because indexed_gzip can't add
+        single seek points to a decoder, the merged index is imported into a new decoder, which replaces the old one.
+        """
+        with self._sqlConnectionForReading() as connection:
+            index = SQLiteIndexedTar._readGzipIndex(connection)
+        # The stored index might not contain the points of earlier calls if the index is read-only or in memory.
+        index.addPoints(list(self.gzipAddedSeekPoints.values()))
+
+        uncompressedOffsets = [point[1] for point in index.points]
+        i = bisect.bisect_right(uncompressedOffsets, offset) - 1
+        if i < 0:
+            return
+        regionBegin = uncompressedOffsets[i]
+        regionEnd = uncompressedOffsets[i + 1] if i + 1 < len(uncompressedOffsets) else offset + index.spacing
+        if index.uncompressedSize > 0:
+            regionEnd = min(regionEnd, index.uncompressedSize)
+
+        truncatedIndex = GzipIndex(
+            index.version,
+            index.flags,
+            index.compressedSize,
+            index.uncompressedSize,
+            self.gzipDenseSeekPointSpacing,
+            index.windowSize,
+            index.points[: i + 1],
+        )
+        with SQLiteIndexedTar._openTarFileParts(self.tarFileParts) as file:
+            decoder = SQLiteIndexedTar._openDecompressor(file, 'gz', self.gzipDenseSeekPointSpacing, 1)
+            truncatedIndex.importInto(decoder)
+            decoder.seek(regionEnd)
+            densePoints = GzipIndex.fromDecoder(decoder).points
+            decoder.close()
+
+        newPoints = [point for point in densePoints if regionBegin < point[1] < regionEnd]
+        if index.addPoints(newPoints) == 0:
+            return
+
+        # Only use the merged index if it decodes the same data as the stored one.
+        rawFileObject = SQLiteIndexedTar._openTarFileParts(self.tarFileParts)
+        decoder = SQLiteIndexedTar._openDecompressor(rawFileObject, 'gz', self.gzipSeekPointSpacing, 1)
+        index.importInto(decoder)
+        decoder.seek(offset)
+        newData = decoder.read(64 * 1024)
+        referenceDecoder, referenceRawFileObject = self._openTarFileObject()
+        referenceDecoder.seek(offset)
+        isValid = referenceDecoder.read(len(newData)) == newData
+        referenceDecoder.close()
+        referenceRawFileObject.close()
+        if not isValid:
+            decoder.close()
+            rawFileObject.close()
+            raise ValueError("The merged seek points do not decode the same data!")
+
+        for point in newPoints:
+            self.gzipAddedSeekPoints[point[1]] = point
+        if printDebug >= 2:
+            print("[Info] Added", len(newPoints), "gzip seek points between offsets", regionBegin, "and", regionEnd)
+
+        if self.tarFileObjectPool:
+            # Decoders currently in use still work correctly with the coarse seek points and are returned later.
+            with self.tarFileObjectPool.lock:
+                replacedObjects = self.tarFileObjectPool.objects
+                self.tarFileObjectPool.objects = [(decoder, rawFileObject)]
+            for pooledObject in replacedObjects:
+                self.tarFileObjectPool._closeObject(pooledObject)
+        else:
+            # Reading threads must not use the decoder while it is replaced, see _tarFileObjectForReading.
+            with self.gzipDensificationLock:
+                replacedObjects = [self.gzipDensifiedFileObjects] if self.gzipDensifiedFileObjects else []
+                self.gzipDensifiedFileObjects = (decoder, rawFileObject)
+            for replacedDecoder, replacedRawFileObject in replacedObjects:
+                replacedDecoder.close()
+                replacedRawFileObject.close()
+
+        if not self.sqlConnection:
+            return
+        with self.sqlConnectionLock:
+            db = self.sqlConnection
+            try:
+                db.execute(
+                    """
+                    CREATE TABLE IF NOT EXISTS "gzipseekpoints" (
+                        "compressedoffset"   INTEGER,
+                        "uncompressedoffset" INTEGER PRIMARY KEY,
+                        "bits"               INTEGER,
+                        "window"             BLOB
+                    );
+                    """
+                )
+                db.executemany('INSERT OR IGNORE INTO "gzipseekpoints" VALUES (?,?,?,?)', newPoints)
+                db.commit()
+            except sqlite3.Error as exception:
+                db.rollback()
+                if printDebug >= 2:
+                    print("[Info] Could not store the added gzip seek points in the index because of:", exception)
+
+    @staticmethod
+    def _readGzipIndex(connection: sqlite3.Connection) -> GzipIndex:
+        """Reads the gzip index stored in the "gzipindex" table including the points added by _addGzipSeekPoints."""
+        index = GzipIndex.read(typing.cast(IO[bytes], SQLiteBlobsFile(connection, 'gzipindex', 'data')))
+        tables = [x[0] for x in connection.execute('SELECT name FROM sqlite_master WHERE type="table"')]
+        if 'gzipseekpoints' in tables:
+            index.addPoints([tuple(row) for row in connection.execute('SELECT * FROM "gzipseekpoints";')])
+        return index
 
     def _tryAddParentFolders(self, path: str) -> None:
         # Add parent folders if they do not exist.
@@ -1110,18 +4280,14 @@ class SQLiteIndexedTar:
         if len(self.parentFolderCache) > 16:
             self.parentFolderCache = self.parentFolderCache[-8:]
 
-        if not self.sqlConnection:
-            raise IndexNotOpenError("This method can not be called without an opened index database!")
-        self.sqlConnection.executemany(
-            'INSERT OR IGNORE INTO "parentfolders" VALUES (?,?)', [(p[0], p[1]) for p in paths]
-        )
+        self.parentFoldersToInsert += paths
 
-    def _setFileInfo(self, row: tuple) -> None:
+    def _insertFileInfoWithEscapedNames(self, row: tuple) -> None:
         if not self.sqlConnection:
             raise IndexNotOpenError("This method can not be called without an opened index database!")
 
         try:
-            self.sqlConnection.execute('INSERT OR REPLACE INTO "files" VALUES (' + ','.join('?' * len(row)) + ');', row)
+            self._insertFileInfos([row])
         except UnicodeEncodeError:
             print("[Warning] Problem caused by file name encoding when trying to insert this row:", row)
             print("[Warning] The file name will now be stored with the bad character being escaped")
@@ -1146,14 +4312,81 @@ class SQLiteIndexedTar:
                 else:
                     checkedRow += [x]
 
-            self.sqlConnection.execute(
-                'INSERT OR REPLACE INTO "files" VALUES (' + ','.join('?' * len(row)) + ');', tuple(checkedRow)
-            )
+            self._insertFileInfos([tuple(checkedRow)])
             print("[Warning] The escaped inserted row is now:", row)
             print()
 
+    def _flushFileInfos(self) -> None:
+        """
+        Inserts all buffered rows into the database. Must be called before querying the "files" or
+        "parentfolders" tables while the index is being created.
+        """
+        if not self.fileInfosToInsert and not self.parentFoldersToInsert:
+            return
+        if not self.sqlConnection:
+            raise IndexNotOpenError("This method can not be called without an opened index database!")
+
+        # The sqlite3 module implicitly opens a transaction before the first INSERT, which stays open until the
+        # commit after index creation. Together with JOURNAL_MODE = OFF and SYNCHRONOUS = OFF set in _openSqlDb,
+        # this avoids any per-row disk synchronization. An aborted index creation is thrown away anyway.
+        rows = self.fileInfosToInsert
+        self.fileInfosToInsert = []
+        if rows:
+            try:
+                self._insertFileInfos(rows)
+            except UnicodeEncodeError:
+                # Insert the batch again row by row in order to find and escape the offending file names.
+                # This is idempotent for the rows already inserted because of INSERT OR REPLACE.
+                for row in rows:
+                    self._insertFileInfoWithEscapedNames(row)
+
+        if self.parentFoldersToInsert:
+            self.sqlConnection.executemany(
+                'INSERT OR IGNORE INTO "parentfolders" VALUES (?,?)', self.parentFoldersToInsert
+            )
+            self.parentFoldersToInsert = []
+
+    def _insertFileInfos(self, rows: List[tuple]) -> None:
+        """Inserts the rows with the columns of the "files" table into the index."""
+        if not self.sqlConnection:
+            raise IndexNotOpenError("This method can not be called without an opened index database!")
+
+        if self.compactIndex:
+            rows = [(self._getDirectoryId(row[0]),) + tuple(row[1:]) for row in rows]
+            table = "compactfiles"
+        else:
+            table = "files"
+        self.sqlConnection.executemany(
+            'INSERT OR REPLACE INTO "{}" VALUES ('.format(table) + ','.join('?' * len(rows[0])) + ');', rows
+        )
+
+    def _getDirectoryId(self, path: str) -> int:
+        """Returns the id of the path in the "directories" table of the compact index and adds it if necessary."""
+        if not self.sqlConnection:
+            raise IndexNotOpenError("This method can not be called without an opened index database!")
+
+        directoryId = self.directoryIds.get(path)
+        if directoryId is None:
+            row = self.sqlConnection.execute('SELECT "id" FROM "directories" WHERE "path" == (?)', (path,)).fetchone()
+            if row:
+                directoryId = row[0]
+            else:
+                cursor = self.sqlConnection.execute('INSERT INTO "directories" ("path") VALUES (?)', (path,))
+                directoryId = cursor.lastrowid
+            self.directoryIds[path] = directoryId
+        return directoryId
+
+    def _setFileInfo(self, row: tuple) -> None:
+        """Buffers the row and inserts the buffered rows in batches of insertBatchSize into the database."""
+        if not self.sqlConnection:
+            raise IndexNotOpenError("This method can not be called without an opened index database!")
+
+        self.fileInfosToInsert.append(row)
         self._tryAddParentFolders(row[0])
 
+        if len(self.fileInfosToInsert) >= self.insertBatchSize:
+            self._flushFileInfos()
+
     def setFileInfo(self, fullPath: str, fileInfo: FileInfo) -> None:
         """
         fullPath : the full path to the file with leading slash (/) for which to set the file info
@@ -1178,6 +4411,50 @@ class SQLiteIndexedTar:
             fileInfo.issparse,
         )
         self._setFileInfo(row)
+        self._flushFileInfos()
+        with self.directoryCacheLock:
+            self.directoryCache.clear()
+
+    def close(self) -> None:
+        """
+        Closes the index database and the file objects to the TAR, which also releases the loaded seek points.
+        In threaded mode, the pooled connections and file objects, which are still in use, are closed when they
+        are returned to the pool.
+        """
+        # Wait for the background thread adding gzip seek points, which uses the pools and the index.
+        with self.gzipDensificationLock:
+            self.gzipDensificationClosed = True
+        if self.gzipDensificationExecutor:
+            self.gzipDensificationExecutor.shutdown(wait=True)
+            self.gzipDensificationExecutor = None
+        if self.gzipDensifiedFileObjects:
+            for fileObject in self.gzipDensifiedFileObjects:
+                fileObject.close()
+            self.gzipDensifiedFileObjects = None
+
+        for pool in [self.sqlConnectionPool, self.tarFileObjectPool]:
+            if pool:
+                pool.close()
+
+        if self.blockPrefetcher:
+            self.blockPrefetcher.close()
+            self.blockPrefetcher = None
+
+        if self.sqlConnection:
+            self.sqlConnection.close()
+            self.sqlConnection = None
+
+        if self.sqlMemoryConnection:
+            self.sqlMemoryConnection.close()
+            self.sqlMemoryConnection = None
+
+        if self.tarFileMap:
+            self.tarFileMap.close()
+            self.tarFileMap = None
+
+        for fileObject in [getattr(self, 'tarFileObject', None), getattr(self, 'rawFileObject', None)]:
+            if fileObject:
+                fileObject.close()
 
     def indexIsLoaded(self) -> bool:
         """Returns true if the SQLite database has been opened for reading and a "files" table exists."""
@@ -1220,8 +4497,13 @@ class SQLiteIndexedTar:
 
             # Check for empty or incomplete indexes. Pretty safe to rebuild the index for these as they
             # are so invalid, noone should miss them. So, recreate index by default for these cases.
-            if 'files' not in tables:
+            if 'files' not in tables and 'compactfiles' not in tables:
                 raise InvalidIndexError("SQLite index is empty")
+            self.compactIndex = 'compactfiles' in tables
+            self.hasInlineFiles = 'inlinefiles' in tables
+            # Only older indexes lack the "arguments" metadata and they can't yet contain any inlined files.
+            self.indexInlineFileSizeLimit = 0
+            self.hasSparseBlocks = 'sparseblocks' in tables
 
             if 'filestmp' in tables or 'parentfolders' in tables:
                 raise InvalidIndexError("SQLite index is incomplete")
@@ -1242,7 +4524,7 @@ class SQLiteIndexedTar:
 
                 if 'tarstats' in metadata:
                     values = json.loads(metadata['tarstats'])
-                    tarStats = os.stat(self.tarFileName)
+                    tarStats = statPath(self.tarFileName)
 
                     # fmt: off
                     if (
@@ -1250,12 +4532,16 @@ class SQLiteIndexedTar:
                         and 'st_size' in values
                         and tarStats.st_size != values['st_size']
                     ):
-                        raise InvalidIndexError( "TAR file for this SQLite index has changed size from",
-                                                 values['st_size'], "to", tarStats.st_size)
+                        self.indexAppendInfo = self._findAppendInfo(metadata, values['st_size'], indexFileName)
+                        if not self.indexAppendInfo:
+                            raise InvalidIndexError( "TAR file for this SQLite index has changed size from",
+                                                     values['st_size'], "to", tarStats.st_size)
                     # fmt: on
 
+                    # Appending to the TAR also changes the modification time.
                     if (
                         self.verifyModificationTime
+                        and not self.indexAppendInfo
                         and hasattr(tarStats, "st_mtime")
                         and 'st_mtime' in values
                         and tarStats.st_mtime != values['st_mtime']
@@ -1266,11 +4552,30 @@ class SQLiteIndexedTar:
                             "to this SQLite index has changed (" + str(tarStats.st_mtime) + ")",
                         )
 
+                # Parts of split archives might have been added, removed, or replaced since the index was created.
+                partsStats = json.loads(metadata['tarparts']) if 'tarparts' in metadata else []
+                if len(self.tarFileParts) > 1 or partsStats:
+                    if len(partsStats) != len(self.tarFileParts):
+                        raise InvalidIndexError(
+                            "The number of parts of the split archive for this SQLite index has changed from",
+                            len(partsStats),
+                            "to",
+                            len(self.tarFileParts),
+                        )
+                    for part, values in zip(self.tarFileParts, partsStats):
+                        partStats = statPath(part)
+                        if partStats.st_size != values['st_size'] or (
+                            self.verifyModificationTime and partStats.st_mtime != values['st_mtime']
+                        ):
+                            raise InvalidIndexError("The part", part, "of the split archive has changed")
+
                 # Check arguments used to create the found index. These are only warnings and not forcing a rebuild
                 # by default.
                 # TODO: Add --force options?
                 if 'arguments' in metadata:
                     indexArgs = json.loads(metadata['arguments'])
+                    if self.hasInlineFiles:
+                        self.indexInlineFileSizeLimit = int(indexArgs.get('inlineFileSizeLimit', 0))
                     argumentsToCheck = [
                         'mountRecursively',
                         'gzipSeekPointSpacing',
@@ -1296,6 +4601,7 @@ class SQLiteIndexedTar:
             except sqlite3.Error:
                 pass
             self.sqlConnection = None
+            self.indexAppendInfo = None
 
             raise e
 
@@ -1396,7 +4702,7 @@ class SQLiteIndexedTar:
         return isTar
 
     @staticmethod
-    def _openCompressedFile(fileobj: BinaryIO, gzipSeekPointSpacing: int, encoding: str) -> Any:
+    def _openCompressedFile(fileobj: BinaryIO, gzipSeekPointSpacing: int, encoding: str, parallelization: int) -> Any:
         """
         Opens a file possibly undoing the compression.
         Returns (tar_file_obj, raw_file_obj, compression, isTar).
@@ -1414,13 +4720,53 @@ class SQLiteIndexedTar:
                 )
             )
 
+        # The zstd frame offsets might already be stored in the index. Therefore, the parallel zstd decoder is only
+        # opened by _openParallelZstdFile after the index has been looked for.
+        tar_file = SQLiteIndexedTar._openDecompressor(
+            fileobj, compression, gzipSeekPointSpacing, 1 if compression == 'zst' else parallelization
+        )
+        return tar_file, fileobj, compression, SQLiteIndexedTar._detectTar(tar_file, encoding)
+
+    @staticmethod
+    def _openDecompressor(
+        fileobj: BinaryIO,
+        compression: str,
+        gzipSeekPointSpacing: int,
+        parallelization: int,
+        blockOffsets: Optional[Dict[int, int]] = None,
+    ) -> Any:
+        """
+        Opens the decompressor for the given and already detected compression on top of fileobj.
+        blockOffsets are the zstd frame offsets stored in the index, which avoid scanning for them again.
+        """
         if compression == 'gz':
             # drop_handles keeps a file handle opening as is required to call tell() during decoding
-            tar_file = indexed_gzip.IndexedGzipFile(fileobj=fileobj, drop_handles=False, spacing=gzipSeekPointSpacing)
-        else:
-            tar_file = cinfo.open(fileobj)
+            return indexed_gzip.IndexedGzipFile(fileobj=fileobj, drop_handles=False, spacing=gzipSeekPointSpacing)
+
+        if compression == 'bz2' and parallelization != 1:
+            # The parallel decoder finds the block offsets by searching for the magic bytes ahead of time and decodes
+            # the blocks on a thread pool. The found offsets are exported via block_offsets like for the serial one.
+            return indexed_bzip2.IndexedBzip2FileParallel(
+                _fileDescriptorOrObject(fileobj),
+                parallelization=parallelization if parallelization > 0 else os.cpu_count(),
+            )
 
-        return tar_file, fileobj, compression, SQLiteIndexedTar._detectTar(tar_file, encoding)
+        if compression == 'xz':
+            return openXzFile(fileobj, parallelization=parallelization if parallelization > 0 else os.cpu_count())
+
+        if compression == 'zst' and parallelization != 1:
+            # The parallel decoder has to know the frame offsets beforehand. Only scan for them if they are not
+            # stored in the index yet. The serial decoder finds them itself while creating the index.
+            if blockOffsets is None:
+                blockOffsets = findZstdFrameOffsets(fileobj, maxFrameSize=ParallelBlockFile.maxBlockSize)
+            decompressedOffsets = sorted(blockOffsets.values()) if blockOffsets else []
+            frameSizes = [end - begin for begin, end in zip(decompressedOffsets, decompressedOffsets[1:])]
+            if blockOffsets and ParallelBlockFile.hasSuitableBlocks(frameSizes):
+                return ParallelZstdFile(
+                    fileobj, blockOffsets, parallelization=parallelization if parallelization > 0 else os.cpu_count()
+                )
+
+        return supportedCompressions[compression].open(fileobj)
 
     @staticmethod
     def _uncheckedRemove(path: Optional[AnyStr]):
@@ -1435,28 +4781,20 @@ class SQLiteIndexedTar:
         except Exception:
             print("[Warning] Could not remove:", path)
 
-    def _loadOrStoreCompressionOffsets(self):
-        # This should be called after the TAR file index is complete (loaded or created).
-        # If the TAR file index was created, then tarfile has iterated over the whole file once
-        # and therefore completed the implicit compression offset creation.
-        if not self.sqlConnection:
-            raise IndexNotOpenError("This method can not be called without an opened index database!")
-        db = self.sqlConnection
-        fileObject = self.tarFileObject
-
+    def _loadCompressionOffsets(self, db: sqlite3.Connection, fileObject: Any) -> bool:
+        """
+        Loads the block offsets or seek points stored in the index into the given decompressor file object.
+        Returns false if they could not be loaded and therefore have to be created from scratch.
+        """
         if (
             hasattr(fileObject, 'set_block_offsets')
             and hasattr(fileObject, 'block_offsets')
-            and self.compression in ['bz2', 'zst']
+            and self.compression in ['bz2', 'zst', 'xz']
         ):
-            if self.compression == 'bz2':
-                table_name = 'bzip2blocks'
-            elif self.compression == 'zst':
-                table_name = 'zstdblocks'
-
             try:
-                offsets = dict(db.execute('SELECT blockoffset,dataoffset FROM {};'.format(table_name)))
+                offsets = dict(db.execute('SELECT blockoffset,dataoffset FROM {};'.format(self._blockTableName())))
                 fileObject.set_block_offsets(offsets)
+                return True
             except Exception:
                 if printDebug >= 2:
                     print(
@@ -1464,14 +4802,7 @@ class SQLiteIndexedTar:
                             self.compression
                         )
                     )
-
-                tables = [x[0] for x in db.execute('SELECT name FROM sqlite_master WHERE type="table";')]
-                if table_name in tables:
-                    db.execute('DROP TABLE {}'.format(table_name))
-                db.execute('CREATE TABLE {} ( blockoffset INTEGER PRIMARY KEY, dataoffset INTEGER )'.format(table_name))
-                db.executemany('INSERT INTO {} VALUES (?,?)'.format(table_name), fileObject.block_offsets().items())
-                db.commit()
-            return
+            return False
 
         if (
             # fmt: off
@@ -1480,75 +4811,122 @@ class SQLiteIndexedTar:
             and self.compression == 'gz'
             # fmt: on
         ):
-            # indexed_gzip index only has a file based API, so we need to write all the index data from the SQL
-            # database out into a temporary file. For that, let's first try to use the same location as the SQLite
-            # database because it should have sufficient writing rights and free disk space.
-            gzindex = None
-            for tmpDir in [os.path.dirname(self.indexFileName), None]:
-                # Try to export data from SQLite database. Note that no error checking against the existence of
-                # gzipindex table is done because the exported data itself might also be wrong and we can't check
-                # against this. Therefore, collate all error checking by catching exceptions.
-                try:
-                    gzindex = tempfile.mkstemp(dir=tmpDir)[1]
-                    with open(gzindex, 'wb') as file:
-                        file.write(db.execute('SELECT data FROM gzipindex').fetchone()[0])
-                    break
-                except Exception:
-                    self._uncheckedRemove(gzindex)
-                    gzindex = None
-
-            if gzindex:
-                try:
-                    fileObject.import_index(filename=gzindex)
-                    return
-                except Exception:
-                    pass
-                finally:
-                    self._uncheckedRemove(gzindex)
+            # Stream the index directly from the SQLite database into indexed_gzip. Note that no error checking
+            # against the existence of gzipindex table is done because the exported data itself might also be wrong
+            # and we can't check against this. Therefore, collate all error checking by catching exceptions.
+            # Indexes stored as one single blob by older versions can be read like this, too.
+            try:
+                tables = [x[0] for x in db.execute('SELECT name FROM sqlite_master WHERE type="table"')]
+                if 'gzipseekpoints' in tables:
+                    SQLiteIndexedTar._readGzipIndex(db).importInto(fileObject)
+                else:
+                    fileObject.import_index(fileobj=SQLiteBlobsFile(db, 'gzipindex', 'data'))
+                return True
+            except Exception:
+                pass
 
-            # Store the offsets into a temporary file and then into the SQLite database
             if printDebug >= 2:
                 print("[Info] Could not load GZip Block offset data. Will create it from scratch.")
+            return False
 
-            # Transparently force index to be built if not already done so. build_full_index was buggy for me.
+        # Note that for the serial xz decoders, loading and storing block indexes is unnecessary because they read
+        # the index included in the file themselves.
+        return self.compression in [None, 'xz']
+
+    def _readZstdFrameOffsets(self, db: sqlite3.Connection) -> Optional[Dict[int, int]]:
+        """Returns the zstd frame offsets stored in the index or None if there are none, e.g., for other formats."""
+        if self.compression != 'zst':
+            return None
+        try:
+            return dict(db.execute('SELECT blockoffset,dataoffset FROM zstdblocks;')) or None
+        except sqlite3.Error:
+            return None
+
+    def _openParallelZstdFile(self) -> None:
+        """
+        Replaces the serial zstd decoder opened by _openCompressedFile with the parallel one if the frames are suited
+        for it. The frame offsets are taken from the index if it has already been loaded and else scanned for.
+        """
+        if self.compression != 'zst' or self.parallelization == 1:
+            return
+
+        blockOffsets = self._readZstdFrameOffsets(self.sqlConnection) if self.sqlConnection else None
+        tarFileObject = SQLiteIndexedTar._openDecompressor(
+            self.rawFileObject, self.compression, self.gzipSeekPointSpacing, self.parallelization, blockOffsets
+        )
+        if isinstance(tarFileObject, ParallelZstdFile):
+            self.tarFileObject.close()
+            self.tarFileObject = tarFileObject
+        else:
+            tarFileObject.close()
+
+    def _blockTableName(self) -> str:
+        return {'bz2': 'bzip2blocks', 'xz': 'xzblocks'}.get(self.compression, 'zstdblocks')
+
+    def _loadOrStoreCompressionOffsets(self):
+        # This should be called after the TAR file index is complete (loaded or created).
+        # If the TAR file index was created, then tarfile has iterated over the whole file once
+        # and therefore completed the implicit compression offset creation.
+        if not self.sqlConnection:
+            raise IndexNotOpenError("This method can not be called without an opened index database!")
+        db = self.sqlConnection
+        fileObject = self.tarFileObject
+        self.compressionOffsetsLoaded = True
+
+        if self._loadCompressionOffsets(db, fileObject):
+            return
+
+        if (
+            hasattr(fileObject, 'set_block_offsets')
+            and hasattr(fileObject, 'block_offsets')
+            and self.compression in ['bz2', 'zst', 'xz']
+        ):
+            table_name = self._blockTableName()
+            tables = [x[0] for x in db.execute('SELECT name FROM sqlite_master WHERE type="table";')]
+            if table_name in tables:
+                db.execute('DROP TABLE {}'.format(table_name))
+            db.execute('CREATE TABLE {} ( blockoffset INTEGER PRIMARY KEY, dataoffset INTEGER )'.format(table_name))
+            db.executemany('INSERT INTO {} VALUES (?,?)'.format(table_name), fileObject.block_offsets().items())
+            db.commit()
+            return
+
+        if (
+            # fmt: off
+            hasattr( fileObject, 'import_index' )
+            and hasattr( fileObject, 'export_index' )
+            and self.compression == 'gz'
+            # fmt: on
+        ):
+            # Transparently force index to be built if not already done so by _createIndex, e.g., when an existing
+            # index without seek points was loaded. build_full_index was buggy for me.
             # Seeking from end not supported, so we have to read the whole data in in a loop
             while fileObject.read(1024 * 1024):
                 pass
 
-            # The created index can unfortunately be pretty large and tmp might actually run out of memory!
-            # Therefore, try different paths, starting with the location where the index resides.
-            gzindex = None
-            for tmpDir in [os.path.dirname(self.indexFileName), None]:
-                gzindex = tempfile.mkstemp(dir=tmpDir)[1]
-                try:
-                    fileObject.export_index(filename=gzindex)
-                    break
-                except indexed_gzip.ZranError:
-                    self._uncheckedRemove(gzindex)
-                    gzindex = None
-
-            if not gzindex or not os.path.isfile(gzindex):
-                print("[Warning] The GZip index required for seeking could not be stored in a temporary file!")
-                print("[Info] This might happen when you are out of space in your temporary file and at the")
-                print("[Info] the index file location. The gzipindex size takes roughly 32kiB per 4MiB of")
-                print("[Info] uncompressed(!) bytes (0.8% of the uncompressed data) by default.")
-                raise RuntimeError("Could not initialize the GZip seek cache.")
-            if printDebug >= 2:
-                print("Exported GZip index size:", os.stat(gzindex).st_size)
-
-            # Store contents of temporary file into the SQLite database
+            # The created index can unfortunately be pretty large. Therefore, stream it in chunks directly into
+            # the SQLite database instead of holding it in memory or in a temporary file.
             tables = [x[0] for x in db.execute('SELECT name FROM sqlite_master WHERE type="table"')]
             if 'gzipindex' in tables:
                 db.execute('DROP TABLE gzipindex')
+            # The points added by _addGzipSeekPoints might belong to an older version of the archive.
+            if 'gzipseekpoints' in tables:
+                db.execute('DROP TABLE gzipseekpoints')
             db.execute('CREATE TABLE gzipindex ( data BLOB )')
-            with open(gzindex, 'rb') as file:
-                db.execute('INSERT INTO gzipindex VALUES (?)', (file.read(),))
+            try:
+                with SQLiteBlobsWriter(db, 'gzipindex', 'data') as gzindex:
+                    fileObject.export_index(fileobj=gzindex)
+                    gzindexSize = gzindex.tell()
+            except (indexed_gzip.ZranError, sqlite3.Error) as exception:
+                db.rollback()
+                print("[Warning] The GZip index required for seeking could not be stored in the index database!")
+                print("[Info] This might happen when you are out of space at the index file location.")
+                print("[Info] The gzipindex size takes roughly 32kiB per 4MiB of uncompressed(!) bytes")
+                print("[Info] (0.8% of the uncompressed data) by default.")
+                raise RuntimeError("Could not initialize the GZip seek cache.") from exception
             db.commit()
-            os.remove(gzindex)
-            return
 
-        # Note that for xz seeking, loading and storing block indexes is unnecessary because it has an index included!
-        if self.compression in [None, 'xz']:
+            if printDebug >= 2:
+                print("Exported GZip index size:", gzindexSize)
             return
 
         assert (
@@ -1591,19 +4969,53 @@ class FolderMountSource:
     This class manages one folder as mount source offering methods for listing folders, reading files, and others.
     """
 
-    __slots__ = ('root', 'mountedTars', 'rootFileInfos')
+    __slots__ = (
+        'root',
+        'mountedTars',
+        'rootFileInfos',
+        'tarFilePaths',
+        'mountPointTrie',
+        'sqliteIndexedTarOptions',
+        'lock',
+        'tarUserCounts',
+        'evictedTars',
+        'openingLocks',
+        'indexedMountPoints',
+    )
+
+    # In lazy mode, the least recently accessed TARs will be closed again when more than this number of them
+    # have been opened in order to release the memory for their decompressors and seek points.
+    maxOpenedLazyTars = 128
 
     def __init__(self, path: str, **sqliteIndexedTarOptions) -> None:
         self.root: str = os.path.realpath(path)
-        # stores mounted TARs per mount point relative (without leading '/') to self.root.
-        self.mountedTars: Dict[str, SQLiteIndexedTar] = {}
+        # stores opened TARs per mount point relative (without leading '/') to self.root. See _acquireMountedTar.
+        self.mountedTars: 'collections.OrderedDict[str, SQLiteIndexedTar]' = collections.OrderedDict()
+        # stores the paths to the TARs for all mount points, even the ones not opened yet in lazy mode
+        self.tarFilePaths: Dict[str, str] = {}
+        # The mount points in tarFilePaths split into their path components as nested dictionaries. The mount point
+        # of a node is stored under the key None, which can't collide with a component. See _findMountedTar.
+        self.mountPointTrie: Dict[Optional[str], Any] = {}
         self.rootFileInfos: Dict[str, FileInfo] = {}
+        self.sqliteIndexedTarOptions = sqliteIndexedTarOptions
+        self.lock = threading.Lock()
+        # The number of callers currently using each opened TAR, see _acquireMountedTar. TARs closed in lazy mode
+        # are only moved to evictedTars and actually closed after the last user released them.
+        self.tarUserCounts: Dict[SQLiteIndexedTar, int] = {}
+        self.evictedTars: Set[SQLiteIndexedTar] = set()
+        # Opening a TAR in lazy mode might create its index, which must not block accesses to the other TARs.
+        # Therefore, self.lock only guards the bookkeeping and these per mount point locks guard the opening.
+        self.openingLocks: Dict[str, threading.Lock] = {}
+        # Mount points, whose index has already been created or checked. When they are reopened after having been
+        # closed in lazy mode, their index must not be cleared and recreated even if clearIndexCache was specified.
+        self.indexedMountPoints: Set[str] = set()
 
         # Find TAR files in this folder and mount them recursively if so requested
         if sqliteIndexedTarOptions.get('recursive', False) and os.path.isdir(self.root):
             stripSuffix = sqliteIndexedTarOptions.get('stripRecursiveTarExtension', False)
             encoding = sqliteIndexedTarOptions.get('encoding', tarfile.ENCODING)
 
+            tarsToMount: List[Tuple[str, str]] = []
             for folder, _, files in os.walk(self.root):
                 assert folder.startswith(self.root)
                 folder = folder[len(self.root) + 1 :]
@@ -1619,14 +5031,165 @@ class FolderMountSource:
                     except argparse.ArgumentTypeError:
                         continue
 
+                    tarsToMount.append((os.path.join(folder, fileName if stripSuffix else filePath), fullPath))
+
+            lazy = sqliteIndexedTarOptions.get('lazy', False)
+            parallelization = sqliteIndexedTarOptions.get('parallelization', 1)
+            if not lazy and parallelization != 1 and len(tarsToMount) > 1:
+                indexedTarPaths = self._createIndexesInParallel([path for _, path in tarsToMount], parallelization)
+                # Do not delete the just created indexes again
+                sqliteIndexedTarOptions = dict(sqliteIndexedTarOptions, clearIndexCache=False)
+                tarsToMount = [(mountPoint, path) for mountPoint, path in tarsToMount if path in indexedTarPaths]
+
+            for mountPoint, fullPath in tarsToMount:
+                if not lazy:
                     try:
-                        indexedTar = SQLiteIndexedTar(fullPath, writeIndex=True, **sqliteIndexedTarOptions)
+                        self.mountedTars[mountPoint] = SQLiteIndexedTar(
+                            fullPath, writeIndex=True, **sqliteIndexedTarOptions
+                        )
                     except Exception:
                         continue
+                    self.indexedMountPoints.add(mountPoint)
+
+                self._addMountPoint(mountPoint, fullPath)
+
+    def _createIndexesInParallel(self, tarFilePaths: List[str], parallelization: int) -> Set[str]:
+        """
+        Creates or checks the indexes for the given TARs in parallel processes, each using a serial decoder,
+        while showing the combined progress. Returns the paths to the TARs, for which this succeeded.
+        """
+        # Only forward the arguments, which influence the index. The others might not even be picklable.
+        indexArguments = [
+            'clearIndexCache',
+            'indexFileName',
+            'indexFolders',
+            'recursive',
+            'gzipSeekPointSpacing',
+            'encoding',
+            'stripRecursiveTarExtension',
+            'ignoreZeros',
+            'verifyModificationTime',
+            'inlineFileSizeLimit',
+            'compactIndex',
+        ]
+        options = {key: value for key, value in self.sqliteIndexedTarOptions.items() if key in indexArguments}
+
+        progressBar = ProgressBar(sum(os.stat(path).st_size for path in tarFilePaths))
+        indexedTarPaths = set()
+        with concurrent.futures.ProcessPoolExecutor(
+            max_workers=parallelization if parallelization > 0 else os.cpu_count(),
+            initializer=_initializeIndexingWorker,
+            initargs=(printDebug,),
+        ) as executor:
+            futures = {executor.submit(FolderMountSource._createIndex, path, options): path for path in tarFilePaths}
+            indexedSize = 0
+            for future in concurrent.futures.as_completed(futures):
+                path = futures[future]
+                if future.result():
+                    indexedTarPaths.add(path)
+                indexedSize += os.stat(path).st_size
+                progressBar.update(indexedSize)
+
+        return indexedTarPaths
+
+    @staticmethod
+    def _createIndex(tarFilePath: str, options: Dict[str, Any]) -> bool:
+        try:
+            SQLiteIndexedTar(tarFilePath, writeIndex=True, **options).close()
+            return True
+        except Exception as exception:
+            if printDebug >= 1:
+                print("[Warning] Could not create the index for", tarFilePath, "because of:", exception)
+            return False
+
+    @contextlib.contextmanager
+    def _acquireMountedTar(self, mountPoint: str) -> Iterator[Optional[SQLiteIndexedTar]]:
+        """
+        Returns the TAR mounted at the given mount point, which will not be closed until the with-statement is left.
+        In lazy mode, it will be opened on first access and the least recently used TARs will be closed if too many
+        have been opened. If the TAR can't be opened, then it will be unmounted and None will be returned.
+        """
+        indexedTar = self._openMountedTar(mountPoint)
+        if not indexedTar:
+            yield None
+            return
+
+        try:
+            yield indexedTar
+        finally:
+            with self.lock:
+                self.tarUserCounts[indexedTar] -= 1
+                closeTar = self.tarUserCounts[indexedTar] == 0 and indexedTar in self.evictedTars
+                if self.tarUserCounts[indexedTar] == 0:
+                    del self.tarUserCounts[indexedTar]
+                if closeTar:
+                    self.evictedTars.remove(indexedTar)
+            if closeTar:
+                indexedTar.close()
+
+    def _openMountedTar(self, mountPoint: str) -> Optional[SQLiteIndexedTar]:
+        """Returns the opened TAR for the mount point and registers the caller as a user. See _acquireMountedTar."""
+        with self.lock:
+            indexedTar = self._useOpenedTar(mountPoint)
+            if indexedTar or mountPoint not in self.tarFilePaths:
+                return indexedTar
+            openingLock = self.openingLocks.setdefault(mountPoint, threading.Lock())
+
+        with openingLock:
+            with self.lock:
+                # Another thread might have opened or unmounted the TAR while we were waiting for the opening lock.
+                indexedTar = self._useOpenedTar(mountPoint)
+                tarFilePath = self.tarFilePaths.get(mountPoint)
+                if indexedTar or not tarFilePath:
+                    return indexedTar
+                options = self.sqliteIndexedTarOptions
+                if mountPoint in self.indexedMountPoints:
+                    options = dict(options, clearIndexCache=False)
+
+            try:
+                indexedTar = SQLiteIndexedTar(tarFilePath, writeIndex=True, **options)
+            except Exception as exception:
+                if printDebug >= 1:
+                    print("[Warning] Could not mount", tarFilePath, "because of:", exception)
+                with self.lock:
+                    self._removeMountPoint(mountPoint)
+                return None
 
-                    mountPoint = os.path.join(folder, fileName if stripSuffix else filePath)
-                    self.mountedTars[mountPoint] = indexedTar
-                    self.rootFileInfos[mountPoint] = _makeMountPointFileInfoFromStats(os.stat(fullPath))
+            tarsToClose = []
+            with self.lock:
+                self.indexedMountPoints.add(mountPoint)
+                self.mountedTars[mountPoint] = indexedTar
+                while len(self.mountedTars) > self.maxOpenedLazyTars:
+                    evictedTar = self.mountedTars.popitem(last=False)[1]
+                    if self.tarUserCounts.get(evictedTar, 0) > 0:
+                        self.evictedTars.add(evictedTar)
+                    else:
+                        tarsToClose.append(evictedTar)
+                self.tarUserCounts[indexedTar] = self.tarUserCounts.get(indexedTar, 0) + 1
+
+        for evictedTar in tarsToClose:
+            evictedTar.close()
+        return indexedTar
+
+    def _useOpenedTar(self, mountPoint: str) -> Optional[SQLiteIndexedTar]:
+        """Registers a user for the TAR if it is already opened and returns it. Must be called with self.lock."""
+        indexedTar = self.mountedTars.get(mountPoint)
+        if indexedTar:
+            self.mountedTars.move_to_end(mountPoint)
+            self.tarUserCounts[indexedTar] = self.tarUserCounts.get(indexedTar, 0) + 1
+        return indexedTar
+
+    def listTarBlockRanges(self) -> Iterator[Tuple[str, str, BlockRange]]:
+        """
+        Yields the archive path, the path inside this folder, and the block range for all regular files in the
+        compressed TARs, which are mounted recursively inside this folder. In lazy mode, this opens all of them.
+        """
+        for mountPoint in sorted(self.tarFilePaths):
+            with self._acquireMountedTar(mountPoint) as indexedTar:
+                if not indexedTar:
+                    continue
+                for path, blockRange in indexedTar.listBlockRanges():
+                    yield indexedTar.tarFileName, '/' + mountPoint + path, blockRange
 
     def setFolderDescriptor(self, fd: int) -> None:
         """
@@ -1637,22 +5200,42 @@ class FolderMountSource:
         os.fchdir(fd)
         self.root = '.'
 
+    def _addMountPoint(self, mountPoint: str, tarFilePath: str) -> None:
+        self.tarFilePaths[mountPoint] = tarFilePath
+        self.rootFileInfos[mountPoint] = _makeMountPointFileInfoFromStats(os.stat(tarFilePath))
+
+        node = self.mountPointTrie
+        for part in mountPoint.split(os.path.sep):
+            node = node.setdefault(part, {})
+        node[None] = mountPoint
+
+    def _removeMountPoint(self, mountPoint: str) -> None:
+        del self.tarFilePaths[mountPoint]
+        del self.rootFileInfos[mountPoint]
+
+        node = self.mountPointTrie
+        for part in mountPoint.split(os.path.sep):
+            node = node[part]
+        del node[None]
+
     def _findMountedTar(self, path: str) -> Optional[Tuple[str, str]]:
         """
-        Returns the mount point, which can be found in self.mountedTars, and the rest of the path.
-        Basically, it splits path at the appropriate mount point boundary.
+        Returns the mount point, which can be found in self.tarFilePaths, and the rest of the path.
+        Basically, it splits path at the appropriate mount point boundary, which is the shortest prefix of path,
+        which is a mount point. Walks down mountPointTrie only as long as there is a mount point below.
         """
-        if not self.mountedTars:
+        if not self.tarFilePaths:
             return None
 
-        # TODO Not sure how performance-critical this can turn out, but maybe do something like bisection instead?
         parts = path.lstrip(os.path.sep).split(os.path.sep)
-        subPath = ""
+        node = self.mountPointTrie
         for i, part in enumerate(parts):
-            subPath = os.path.join(subPath, part)
-            if subPath in self.mountedTars:
-                pathInsideTar = os.path.join(*parts[i + 1 :]) if i + 1 < len(parts) else "/"
-                return subPath, pathInsideTar
+            node = node.get(part)
+            if node is None:
+                return None
+            if None in node:
+                pathInsideTar = os.path.sep.join(parts[i + 1 :]) if i + 1 < len(parts) else "/"
+                return node[None], pathInsideTar
         return None
 
     def _realpath(self, path: str) -> str:
@@ -1691,7 +5274,8 @@ class FolderMountSource:
         if pathSplitAtMountPoint:
             mountPoint, pathInMountPoint = pathSplitAtMountPoint
             if pathInMountPoint and pathInMountPoint != '/':
-                fileInfo = self.mountedTars[mountPoint].getFileInfo(pathInMountPoint, fileVersion=fileVersion)
+                with self._acquireMountedTar(mountPoint) as indexedTar:
+                    fileInfo = indexedTar.getFileInfo(pathInMountPoint, fileVersion=fileVersion) if indexedTar else None
 
                 if isinstance(fileInfo, FileInfo):
                     # Dereference hard links
@@ -1701,7 +5285,7 @@ class FolderMountSource:
                             return self.getFileInfo(os.path.join(mountPoint, targetLink), fileVersion)
                     return fileInfo
                 return None
-            return self.rootFileInfos[mountPoint]
+            return self.rootFileInfos.get(mountPoint)
 
         # This is a bit of problematic design, however, the fileVersions count from 1 for the user.
         # And as -1 means the last version, 0 should also mean the first version ...
@@ -1719,7 +5303,8 @@ class FolderMountSource:
         pathSplitAtMountPoint = self._findMountedTar(path)
         if pathSplitAtMountPoint:
             mountPoint, pathInMountPoint = pathSplitAtMountPoint
-            return self.mountedTars[mountPoint].listDir(pathInMountPoint)
+            with self._acquireMountedTar(mountPoint) as indexedTar:
+                return indexedTar.listDir(pathInMountPoint) if indexedTar else None
 
         realpath = self._realpath(path)
         if os.path.isdir(realpath):
@@ -1731,7 +5316,8 @@ class FolderMountSource:
         pathSplitAtMountPoint = self._findMountedTar(path)
         if pathSplitAtMountPoint:
             mountPoint, pathInMountPoint = pathSplitAtMountPoint
-            return self.mountedTars[mountPoint].fileVersions(pathInMountPoint)
+            with self._acquireMountedTar(mountPoint) as indexedTar:
+                return indexedTar.fileVersions(pathInMountPoint) if indexedTar else 0
         return 1 if self._exists(path) else 0
 
     def read(self, path: str, size: int, offset: int, fileInfo: Optional[FileInfo] = None) -> bytes:
@@ -1741,7 +5327,10 @@ class FolderMountSource:
         pathSplitAtMountPoint = self._findMountedTar(path)
         if pathSplitAtMountPoint:
             mountPoint, pathInMountPoint = pathSplitAtMountPoint
-            return self.mountedTars[mountPoint].read(pathInMountPoint, size, offset, fileInfo)
+            with self._acquireMountedTar(mountPoint) as indexedTar:
+                if not indexedTar:
+                    raise ValueError("Specified path '{}' is not a file that can be read!".format(path))
+                return indexedTar.read(pathInMountPoint, size, offset, fileInfo)
 
         realpath = self._realpath(path)
         if not self._exists(path):
@@ -1766,6 +5355,8 @@ class TarMount(fuse.Operations):
        - Resolve hard links returned by SQLiteIndexedTar
        - Get actual file contents either by directly reading from the TAR or by using StenciledFile and tarfile
        - Provide hidden folders as an interface to get older versions of updated files
+       - Provide special files, which are not listed, like /.ratarmount-blocks with metadata about the mount
+         and /.ratarmount-stats with performance statistics
     """
 
     __slots__ = (
@@ -1774,8 +5365,24 @@ class TarMount(fuse.Operations):
         'mountPoint',
         'mountPointFd',
         'mountPointWasCreated',
+        'blockCache',
+        'specialFiles',
+        'specialFileContents',
+        'specialFilesLock',
+        'pathFilters',
+        'mergedPathFilter',
+        'unfilteredMountSources',
     )
 
+    # Special files, which are generated anew on each getattr call instead of only on first access.
+    # Reads return the contents generated by the last getattr call, so that they are consistent with its st_size.
+    volatileSpecialFiles = ('/.ratarmount-stats',)
+    # Special files larger than this are written to a temporary file on disk instead of being kept in memory.
+    maxInMemorySpecialFileSize = 1024 * 1024
+    # Path filters are only created for union mounts of at least this many archives. For fewer archives, querying
+    # each index is cheap enough and does not warrant listing all paths of all archives when mounting.
+    minArchivesForPathFilters = 32
+
     def __init__(self, pathToMount: Union[str, List[str]], mountPoint: str, **sqliteIndexedTarOptions) -> None:
         if not isinstance(pathToMount, list):
             try:
@@ -1784,6 +5391,7 @@ class TarMount(fuse.Operations):
             except Exception:
                 pass
 
+        self.blockCache: Optional[BlockCache] = sqliteIndexedTarOptions.get('blockCache', None)
         self.mountSources: List[Union[SQLiteIndexedTar, FolderMountSource]] = [
             SQLiteIndexedTar(tarFile, writeIndex=True, **sqliteIndexedTarOptions)
             if not os.path.isdir(tarFile)
@@ -1791,7 +5399,29 @@ class TarMount(fuse.Operations):
             for tarFile in pathToMount
         ]
 
-        self.rootFileInfo = _makeMountPointFileInfoFromStats(os.stat(pathToMount[0]))
+        self.rootFileInfo = _makeMountPointFileInfoFromStats(statPath(pathToMount[0]))
+
+        # Bloom filters for each mount source in mountSources and for all of them together, so that lookups of paths
+        # contained in no or only a few of many union mounted archives don't have to query each index.
+        # Folders can change while mounted and therefore have no filter, i.e., they are always queried.
+        self.pathFilters: List[Optional[PathBloomFilter]] = [None] * len(self.mountSources)
+        self.mergedPathFilter: Optional[PathBloomFilter] = None
+        if sum(isinstance(mountSource, SQLiteIndexedTar) for mountSource in self.mountSources) >= max(
+            2, self.minArchivesForPathFilters
+        ):
+            self._createPathFilters()
+        # Indexes of the mount sources without a filter, which still have to be queried after the merged filter
+        # rejected a path.
+        self.unfilteredMountSources = [i for i, pathFilter in enumerate(self.pathFilters) if not pathFilter]
+
+        # Special files are generated on first access and hide files with the same path in the mount sources.
+        # The generators write the contents into the given file object, see _getSpecialFile.
+        self.specialFiles: Dict[str, Callable[[IO[bytes]], None]] = {
+            '/.ratarmount-blocks': self._writeBlockMetadata,
+            '/.ratarmount-stats': self._writeStatistics,
+        }
+        self.specialFileContents: Dict[str, IO[bytes]] = {}
+        self.specialFilesLock = threading.Lock()
 
         # Create mount point if it does not exist
         self.mountPointWasCreated = False
@@ -1813,6 +5443,43 @@ class TarMount(fuse.Operations):
         except Exception:
             pass
 
+    def _createPathFilters(self) -> None:
+        t0 = time.time()
+        archives = [
+            (i, mountSource)
+            for i, mountSource in enumerate(self.mountSources)
+            if isinstance(mountSource, SQLiteIndexedTar)
+        ]
+        pathCounts = [mountSource.pathCount() for _, mountSource in archives]
+        self.mergedPathFilter = PathBloomFilter(sum(pathCounts))
+        for (i, mountSource), pathCount in zip(archives, pathCounts):
+            pathFilter = PathBloomFilter(pathCount)
+            for path in mountSource.listPaths():
+                pathFilter.add(path)
+                self.mergedPathFilter.add(path)
+            self.pathFilters[i] = pathFilter
+
+        if printDebug >= 2:
+            print("[Info] Creating the path filters for the union mount took {:.2f}s".format(time.time() - t0))
+
+    def _getMountSourcesForPath(
+        self, filePath: str, reverse: bool = False
+    ) -> Iterator[Union[SQLiteIndexedTar, FolderMountSource]]:
+        """
+        Yields the mount sources, which might contain the given path, in the order of mountSources or reversed.
+        The filters are only checked while iterating, so that stopping at the first found path is cheap.
+        """
+        indexes: Sequence[int] = range(len(self.mountSources))
+        # Same normalization as done by SQLiteIndexedTar.getFileInfo. The root has no row in the index.
+        filePath = '/' + os.path.normpath(filePath).lstrip('/')
+        if self.mergedPathFilter and filePath != '/' and filePath not in self.mergedPathFilter:
+            indexes = self.unfilteredMountSources
+
+        for i in reversed(indexes) if reverse else indexes:
+            pathFilter = self.pathFilters[i]
+            if not pathFilter or filePath == '/' or filePath in pathFilter:
+                yield self.mountSources[i]
+
     def _getUnionMountFileInfo(
         self, filePath: str, fileVersion: int = 0
     ) -> Optional[Tuple[FileInfo, Optional[Union[SQLiteIndexedTar, FolderMountSource]]]]:
@@ -1826,8 +5493,9 @@ class TarMount(fuse.Operations):
         # We need to keep the sign of the fileVersion in order to forward it to SQLiteIndexedTar.
         # When the requested version can't be found in a mount source, increment negative specified versions
         # by the amount of versions in that mount source or decrement the initially positive version.
+        # Mount sources not containing the path at all also contain no version of it and can be skipped.
         if fileVersion <= 0:
-            for mountSource in reversed(self.mountSources):
+            for mountSource in self._getMountSourcesForPath(filePath, reverse=True):
                 fileInfo = mountSource.getFileInfo(filePath, fileVersion=fileVersion)
                 if isinstance(fileInfo, FileInfo):
                     return fileInfo, mountSource
@@ -1835,7 +5503,7 @@ class TarMount(fuse.Operations):
                 if fileVersion > 0:
                     break
         else:  # fileVersion >= 1
-            for mountSource in self.mountSources:
+            for mountSource in self._getMountSourcesForPath(filePath):
                 fileInfo = mountSource.getFileInfo(filePath, fileVersion=fileVersion)
                 if isinstance(fileInfo, FileInfo):
                     return fileInfo, mountSource
@@ -1946,6 +5614,77 @@ class TarMount(fuse.Operations):
 
         raise fuse.FuseOSError(fuse.errno.ENOENT)
 
+    def _writeBlockMetadata(self, file: IO[bytes]) -> None:
+        """
+        Writes one JSON object per line for each regular file in the compressed archives with the range of
+        compression blocks or seek points it spans, so that clients can group their reads by block.
+        This includes the TARs recursively mounted inside folders, which are opened for this in lazy mode.
+        The lines are streamed into the file, which is kept on disk for archives with many files.
+        """
+        blockRanges: Iterable[Tuple[str, str, BlockRange]]
+        for mountSource in self.mountSources:
+            if isinstance(mountSource, SQLiteIndexedTar):
+                archive = mountSource.tarFileName
+                blockRanges = ((archive, path, blockRange) for path, blockRange in mountSource.listBlockRanges())
+            else:
+                blockRanges = mountSource.listTarBlockRanges()
+
+            for archive, path, blockRange in blockRanges:
+                # fmt: off
+                file.write((json.dumps({
+                    'path'             : path,
+                    'archive'          : archive,
+                    'firstblock'       : blockRange.firstblock,
+                    'lastblock'        : blockRange.lastblock,
+                    'compressedoffset' : blockRange.compressedoffset,
+                    'compressedsize'   : blockRange.compressedsize,
+                }) + '\n').encode())
+                # fmt: on
+
+    def _writeStatistics(self, file: IO[bytes]) -> None:
+        """
+        Returns the counters and latency histograms of performanceStatistics and the block cache statistics as JSON.
+        The ratio of decoded to requested bytes shows the read amplification caused by seeking in compressed TARs.
+        """
+        statistics = performanceStatistics.toDict()
+        counters = statistics['counters']
+        if counters.get('decoder.bytesRequested') and 'decoder.bytesDecoded' in counters:
+            statistics['decoderAmplification'] = counters['decoder.bytesDecoded'] / counters['decoder.bytesRequested']
+
+        hits = counters.get('index.directoryCache.hits', 0)
+        misses = counters.get('index.directoryCache.misses', 0)
+        if hits + misses > 0:
+            statistics['directoryCacheHitRate'] = hits / (hits + misses)
+
+        if self.blockCache:
+            blockCacheStatistics: Dict[str, Any] = dict(self.blockCache.statistics())
+            accesses = blockCacheStatistics['hits'] + blockCacheStatistics['misses']
+            if accesses > 0:
+                blockCacheStatistics['hitRate'] = blockCacheStatistics['hits'] / accesses
+            statistics['blockCache'] = blockCacheStatistics
+
+        file.write((json.dumps(statistics, indent=2) + '\n').encode())
+
+    def _getSpecialFile(self, path: str, regenerate: bool = False) -> Optional[IO[bytes]]:
+        """
+        Returns the file object with the contents of the special file at path or None if path is not one.
+        The contents are generated on first access or if regenerate is true. The returned file object must only
+        be accessed while holding specialFilesLock.
+        """
+        if path not in self.specialFiles:
+            return None
+
+        with self.specialFilesLock:
+            file = self.specialFileContents.get(path)
+            if file and not regenerate:
+                return file
+            if file:
+                file.close()
+            file = typing.cast(IO[bytes], tempfile.SpooledTemporaryFile(max_size=self.maxInMemorySpecialFileSize))
+            self.specialFiles[path](file)
+            self.specialFileContents[path] = file
+            return file
+
     def _getUnionMountListDir(self, folderPath: str) -> Optional[Set[str]]:
         """
         Returns the set of all folder contents over all mount sources or None if the path was found in none of them.
@@ -1954,7 +5693,7 @@ class TarMount(fuse.Operations):
         files: Set[str] = set()
         folderExists = False
 
-        for mountSource in self.mountSources:
+        for mountSource in self._getMountSourcesForPath(folderPath):
             result = mountSource.listDir(folderPath)
             if result:
                 files = files.union(result)
@@ -1969,7 +5708,23 @@ class TarMount(fuse.Operations):
                 mountSource.setFolderDescriptor(self.mountPointFd)
 
     @overrides(fuse.Operations)
+    def destroy(self, path) -> None:
+        if self.blockCache and printDebug >= 2:
+            print("[Info] Block cache statistics:", self.blockCache.statistics())
+
+    @overrides(fuse.Operations)
+    @timedOperation('fuse.getattr')
     def getattr(self, path: str, fh=None) -> Dict[str, Any]:
+        specialFile = self._getSpecialFile(path, regenerate=path in self.volatileSpecialFiles)
+        if specialFile is not None:
+            statDict = {"st_" + key: getattr(self.rootFileInfo, key) for key in ('mtime', 'uid', 'gid')}
+            statDict['st_mtime'] = int(statDict['st_mtime'])
+            statDict['st_mode'] = stat.S_IFREG | 0o444
+            with self.specialFilesLock:
+                statDict['st_size'] = specialFile.seek(0, io.SEEK_END)
+            statDict['st_nlink'] = 1
+            return statDict
+
         fileInfo, filePath, _ = self._getFileInfo(path)
 
         # Dereference hard links
@@ -1994,6 +5749,7 @@ class TarMount(fuse.Operations):
         return statDict
 
     @overrides(fuse.Operations)
+    @timedOperation('fuse.readdir')
     def readdir(self, path: str, fh):
         # we only need to return these special directories. FUSE automatically expands these and will not ask
         # for paths like /../foo/./../bar, so we don't need to worry about cleaning such paths
@@ -2021,18 +5777,27 @@ class TarMount(fuse.Operations):
 
         # Print all available versions of the file at filePath as the contents of the special '.versions' folder
         version = 0
-        for mountSource in self.mountSources:
+        for mountSource in self._getMountSourcesForPath(path):
             for _ in range(mountSource.fileVersions(path)):
                 version += 1
                 yield str(version)
 
     @overrides(fuse.Operations)
+    @timedOperation('fuse.readlink')
     def readlink(self, path: str) -> str:
         fileInfo, _, _ = self._getFileInfo(path)
         return fileInfo.linkname
 
     @overrides(fuse.Operations)
+    @timedOperation('fuse.read')
     def read(self, path: str, size: int, offset: int, fh: int) -> bytes:
+        specialFile = self._getSpecialFile(path)
+        if specialFile is not None:
+            with self.specialFilesLock:
+                specialFile.seek(offset)
+                return specialFile.read(size)
+        performanceStatistics.count('fuse.read.bytesRequested', size)
+
         fileInfo, mountSource, filePath = self._getFileInfo(path)
 
         # mountSource may only be None for the root folder. However, this read method
@@ -2058,11 +5823,17 @@ class TarFileType:
         self.encoding = encoding
 
     def __call__(self, tarFile: str) -> Tuple[str, Optional[str]]:
-        if not os.path.exists(tarFile):
+        if isRemotePath(tarFile):
+            try:
+                fileSize = statPath(tarFile).st_size
+            except (OSError, RatarmountError) as exception:
+                raise argparse.ArgumentTypeError("Remote file '{}' can't be accessed: {}".format(tarFile, exception))
+        elif not os.path.exists(tarFile):
             raise argparse.ArgumentTypeError("File '{}' does not exist!".format(tarFile))
-
-        with open(tarFile, 'rb') as fileobj:
+        else:
             fileSize = os.stat(tarFile).st_size
+
+        with openPath(tarFile) as fileobj:
             compression = SQLiteIndexedTar._detectCompression(fileobj)
 
             try:
@@ -2102,6 +5873,15 @@ class TarFileType:
         return tarFile, compression
 
 
+def _parseByteSize(size: str) -> int:
+    """Parses sizes like '512M' or '1.5G' using binary prefixes into the number of bytes."""
+    units = {'': 1, 'K': 1024, 'M': 1024 ** 2, 'G': 1024 ** 3, 'T': 1024 ** 4}
+    match = re.fullmatch(r'([0-9]+(?:\.[0-9]*)?) *([KMGT]?)(?:i?B)?', size.strip(), re.IGNORECASE)
+    if not match:
+        raise argparse.ArgumentTypeError("Invalid size '{}'! Specify it like 512M or 1G.".format(size))
+    return int(float(match.group(1)) * units[match.group(2).upper()])
+
+
 class _CustomFormatter(argparse.ArgumentDefaultsHelpFormatter, argparse.RawDescriptionHelpFormatter):
     pass
 
@@ -2238,6 +6018,84 @@ seeking capabilities when opening that file.
         'not benefit from faster seek times. A seek point takes roughly 32kiB. '
         'So, smaller distances lead to more responsive seeking but may explode the index size!' )
 
+    parser.add_argument(
+        '--gzip-dense-seek-point-spacing', type = float, default = 0,
+        help =
+        'If greater than 0, regions between two gzip seek points, which are read randomly multiple times, '
+        'get additional seek points with this spacing in MiB while mounted. These are also stored in the index. '
+        'This allows a coarse --gzip-seek-point-spacing, i.e., a smaller index, while frequently accessed '
+        'files still can be read quickly.' )
+
+    parser.add_argument(
+        '-P', '--parallelization', type = int, default = 1,
+        help = 'If an integer other than 1 is specified, then the threaded parallel bzip2 decoder will be used '
+               'with the specified number of decoder threads. This speeds up index creation and sequential reads '
+               'of bzip2 compressed TARs. 0 means that as many threads as there are cores will be used. '
+               'The same holds for zstd compressed TARs consisting of multiple frames, e.g., created with pzstd '
+               'or in the seekable format, whose frame offsets can be read without decompressing them, and for '
+               'xz compressed TARs consisting of multiple blocks. '
+               'Furthermore, the indexes for TARs found in recursively mounted folders and for TARs nested inside '
+               'uncompressed TARs will be created in this many parallel processes.' )
+
+    parser.add_argument(
+        '--threaded', action = 'store_true', default = False,
+        help = 'Let FUSE call the file system operations from multiple threads. Each thread will use its own '
+               'read-only connection to the index and its own decompressor, so that concurrent reads of different '
+               'files inside compressed TARs are not serialized anymore.' )
+
+    parser.add_argument(
+        '--lazy', action = 'store_true', default = False,
+        help = 'Open TARs found recursively inside mounted folders only on first access to them instead of at '
+               'startup, and load the compression seek points of already indexed TARs only on the first read. '
+               'The least recently accessed TARs will be closed again when too many have been opened. '
+               'This shortens the startup time when mounting folders containing many TARs.' )
+
+    parser.add_argument(
+        '--cache-size', type = _parseByteSize, default = '128M',
+        help = 'The maximum size of the in-memory cache for decompressed blocks, e.g., 512M or 1G. It is shared by '
+               'all mounted compressed TARs and avoids decoding the same data again for nearby reads, like the '
+               'consecutive chunks FUSE requests. 0 disables the cache.' )
+
+    parser.add_argument(
+        '--prefetch', type = int, default = 0,
+        help = 'The number of decompressed blocks of 1 MiB to decode ahead in the background when sequential reads '
+               'of compressed TARs are detected, e.g., for cat or cp. Only has an effect if the cache is enabled '
+               'with --cache-size. Each mounted TAR opens one more decompressor for it when sequential reads are '
+               'detected. 0 disables prefetching.' )
+
+    parser.add_argument(
+        '--inline-file-size-limit', type = _parseByteSize, default = '0',
+        help = 'When creating the index, store the contents of files up to this size, e.g., 4K, directly inside '
+               'the index. Reading these files will then not require any seeking or decompression inside the '
+               'archive, which is especially costly for many small files in bzip2 compressed TARs. '
+               '0 disables this.' )
+
+    parser.add_argument(
+        '--join-split-archives', action='store_true', default = False,
+        help = 'If the first part of a split archive, e.g., archive.tar.001, is specified, then mount all '
+               'consecutively numbered parts as one concatenated archive. Without this, numbered files are '
+               'mounted on their own because they might also be independent archives, e.g., rotated backups.' )
+
+    parser.add_argument(
+        '--compact-index', action='store_true', default = False,
+        help = 'When creating the index, store each folder path only once and refer to it by an integer id '
+               'instead of repeating the full parent path for each file. This makes the index of archives with '
+               'many files in deep folder hierarchies noticeably smaller, so that more of it fits into the page '
+               'cache. Already existing indexes are used as they are.' )
+
+    parser.add_argument(
+        '--index-memory-mode', type = str, default = 'disk', choices = [ 'disk', 'mmap', 'memory' ],
+        help = 'Specifies how the index is accessed after loading it. "mmap" memory-maps the index file and uses '
+               'a larger SQLite page cache. "memory" copies the whole index into memory at mount time. '
+               'Both speed up metadata lookups for many files, e.g., by find or ls -R, at the cost of memory.' )
+
+    parser.add_argument(
+        '--extract', type = str, metavar = 'FILE_LIST',
+        help = 'Instead of mounting, extract the files listed in the given file, one path per line, or "-" for '
+               'standard input, from the first mount source into the mount point folder. The files are read in '
+               'the order they are stored in the archive, which avoids seeking backwards inside compressed TARs '
+               'and is much faster than copying them from the mounted archive in arbitrary order.' )
+
     parser.add_argument(
         '-p', '--prefix', type = str, default = '',
         help = '[deprecated] Use "-o modules=subdir,subdir=<prefix>" instead. '
@@ -2266,7 +6124,8 @@ seeking capabilities when opening that file.
         help = 'By default, only the TAR file size is checked to match the one in the found existing ratarmount index. '
                'If this option is specified, then also check the modification timestamp. But beware that the mtime '
                'might change during copying or downloading without the contents changing. So, this check might cause '
-               'false positives.' )
+               'false positives. If an uncompressed TAR has only grown, e.g., because of tar --append, then only '
+               'the appended members are added to the existing index instead of recreating it.' )
 
     parser.add_argument(
         '-s', '--strip-recursive-tar-extension', action = 'store_true',
@@ -2290,6 +6149,18 @@ seeking capabilities when opening that file.
                '--index-folder ~/.ratarmount will only test ~/.ratarmount as a storage location and nothing else. '
                'Instead, it will first try ~/.ratarmount and the folder "foo,9000". ' )
 
+    parser.add_argument(
+        '--remote-cache-folder', default = os.path.join( "~", ".ratarmount", "remote-cache" ),
+        help = 'Folder for caching indexes found next to remote archives specified as http(s):// or s3:// URLs '
+               'and, if enabled with --remote-cache-size, downloaded chunks of them. Cached chunks are reused across '
+               'mounts as long as the remote object did not change.' )
+
+    parser.add_argument(
+        '--remote-cache-size', type = _parseByteSize, default = '0',
+        help = 'The maximum size of all chunks of remote archives cached in --remote-cache-folder, e.g., 512M '
+               'or 4G. The least recently used chunks are deleted when it is exceeded. The chunks read for creating '
+               'the index are not cached. 0 only caches chunks in memory.' )
+
     parser.add_argument(
         '-o', '--fuse', type = str, default = '',
         help = 'Comma separated FUSE options. See "man mount.fuse" for help. '
@@ -2314,11 +6185,13 @@ seeking capabilities when opening that file.
     args = parser.parse_args(rawArgs)
 
     args.gzipSeekPointSpacing = args.gzip_seek_point_spacing * 1024 * 1024
+    args.gzipDenseSeekPointSpacing = int(args.gzip_dense_seek_point_spacing * 1024 * 1024)
 
     # This is a hack but because we have two positional arguments (and want that reflected in the auto-generated help),
     # all positional arguments, including the mountpath will be parsed into the tarfilepaths namespace and we have to
     # manually separate them depending on the type.
-    if os.path.isdir(args.mount_source[-1]) or not os.path.exists(args.mount_source[-1]):
+    lastSource = args.mount_source[-1]
+    if not isRemotePath(lastSource) and (os.path.isdir(lastSource) or not os.path.exists(lastSource)):
         args.mount_point = args.mount_source[-1]
         args.mount_source = args.mount_source[:-1]
     if not args.mount_source:
@@ -2333,7 +6206,13 @@ seeking capabilities when opening that file.
 
     # Automatically generate a default mount path
     if not args.mount_point:
-        autoMountPoint = stripSuffixFromTarFile(args.mount_source[0])
+        mountSource = args.mount_source[0]
+        if isRemotePath(mountSource):
+            # Remote archives are mounted into the current folder like downloads
+            mountSource = os.path.basename(urllib.parse.urlparse(mountSource).path.rstrip('/')) or 'remote.tar'
+        elif args.join_split_archives and len(findSplitArchiveParts(mountSource)) > 1:
+            mountSource = os.path.splitext(mountSource)[0]
+        autoMountPoint = stripSuffixFromTarFile(mountSource)
         if args.mount_point == autoMountPoint:
             args.mount_point = os.path.splitext(args.mount_source[0])[0]
         else:
@@ -2350,6 +6229,61 @@ seeking capabilities when opening that file.
     return args
 
 
+def extractFiles(tarFilePath: str, outputFolder: str, fileList: str, **sqliteIndexedTarOptions) -> None:
+    """Extracts the paths listed in fileList, a file name or '-' for stdin, into outputFolder in archive order."""
+    if fileList == '-':
+        paths = sys.stdin.read().splitlines()
+    else:
+        with open(fileList, 'rt', encoding='utf-8') as file:
+            paths = file.read().splitlines()
+    paths = ['/' + path.strip('/') for path in paths if path.strip('/')]
+
+    outputFolder = os.path.realpath(outputFolder)
+    outputPaths = {}
+    for path in paths:
+        outputPath = os.path.realpath(os.path.join(outputFolder, path.lstrip('/')))
+        if os.path.commonpath([outputFolder, outputPath]) != outputFolder:
+            raise ValueError("Specified path '{}' would be extracted outside of the output folder!".format(path))
+        outputPaths[path] = outputPath
+
+    indexedTar = SQLiteIndexedTar(tarFilePath, writeIndex=True, **sqliteIndexedTarOptions)
+    fileInfos = {path: indexedTar.getFileInfo(path) for path in outputPaths}
+    symbolicLinks = {
+        path: fileInfo.linkname
+        for path, fileInfo in fileInfos.items()
+        if isinstance(fileInfo, FileInfo) and stat.S_ISLNK(fileInfo.mode)
+    }
+
+    outputFile = None
+    try:
+        for path, offset, data in indexedTar.readFiles(path for path in paths if path not in symbolicLinks):
+            if offset == 0:
+                if outputFile:
+                    outputFile.close()
+                os.makedirs(os.path.dirname(outputPaths[path]), exist_ok=True)
+                outputFile = open(outputPaths[path], 'wb')
+            outputFile.write(data)
+    finally:
+        if outputFile:
+            outputFile.close()
+
+    # Create symbolic links only after all files have been written so that no file is written through them.
+    for path, linkname in symbolicLinks.items():
+        os.makedirs(os.path.dirname(outputPaths[path]), exist_ok=True)
+        if os.path.lexists(outputPaths[path]):
+            os.remove(outputPaths[path])
+        os.symlink(linkname, outputPaths[path])
+
+    for path, outputPath in outputPaths.items():
+        fileInfo = fileInfos[path]
+        if isinstance(fileInfo, FileInfo):
+            os.utime(outputPath, (fileInfo.mtime, fileInfo.mtime), follow_symlinks=path not in symbolicLinks)
+    indexedTar.close()
+
+    if printDebug >= 1:
+        print("[Info] Extracted {} files into {}".format(len(outputPaths), outputFolder))
+
+
 def cli(rawArgs: Optional[List[str]] = None) -> None:
     """Command line interface for ratarmount. Call with args = [ '--help' ] for a description."""
 
@@ -2380,28 +6314,55 @@ def cli(rawArgs: Optional[List[str]] = None) -> None:
     global printDebug
     printDebug = args.debug
 
-    fuseOperationsObject = TarMount(
+    RemoteFile.cacheFolder = os.path.expanduser(args.remote_cache_folder) if args.remote_cache_folder else None
+    RemoteFile.cacheSize = args.remote_cache_size
+
+    sqliteIndexedTarOptions = dict(
         # fmt: off
-        pathToMount                = args.mount_source,
         clearIndexCache            = args.recreate_index,
         recursive                  = args.recursive,
         gzipSeekPointSpacing       = args.gzipSeekPointSpacing,
-        mountPoint                 = args.mount_point,
         encoding                   = args.encoding,
         ignoreZeros                = args.ignore_zeros,
         verifyModificationTime     = args.verify_mtime,
         stripRecursiveTarExtension = args.strip_recursive_tar_extension,
         indexFileName              = args.index_file,
         indexFolders               = args.index_folders,
+        parallelization            = args.parallelization,
+        threaded                   = args.threaded,
+        blockCache                 = BlockCache(args.cache_size) if args.cache_size > 0 else None,
+        prefetch                   = args.prefetch,
+        lazy                       = args.lazy,
+        inlineFileSizeLimit        = args.inline_file_size_limit,
+        gzipDenseSeekPointSpacing  = args.gzipDenseSeekPointSpacing,
+        compactIndex               = args.compact_index,
+        indexMemoryMode            = args.index_memory_mode,
+        joinSplitArchives          = args.join_split_archives,
         # fmt: on
     )
 
+    if args.extract:
+        if os.path.isdir(args.mount_source[0]):
+            print("[Error] Files can only be extracted from archives, not from folders!")
+            sys.exit(1)
+        try:
+            extractFiles(args.mount_source[0], args.mount_point, args.extract, **sqliteIndexedTarOptions)
+        except ValueError as exception:
+            print("[Error]", exception)
+            sys.exit(1)
+        return
+
+    fuseOperationsObject = TarMount(
+        pathToMount=args.mount_source, mountPoint=args.mount_point, **sqliteIndexedTarOptions
+    )
+
     fuse.FUSE(
         # fmt: on
         operations=fuseOperationsObject,
         mountpoint=args.mount_point,
         foreground=args.foreground,
-        nothreads=True,  # Can't access SQLite database connection object from multiple threads
+        # The SQLite connections and decompressors are only pooled per thread if --threaded was specified
+        nothreads=not args.threaded,
         # fmt: off
         **fusekwargs
     )
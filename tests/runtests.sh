@@ -492,6 +492,42 @@ checkAutomaticIndexRecreation()
     echoerr "[${FUNCNAME[0]}] Tested successfully"
 )
 
+checkIndexAppend()
+(
+    tmpFolder="$( mktemp -d )" || returnError "$LINENO" 'Failed to create temporary directory'
+    cd -- "$tmpFolder" || returnError "$LINENO" 'Failed to cd into temporary directory'
+
+    archive='momo.tar'
+    mountFolder='momo'
+
+    echo 'mimi' > meme
+    tar -cf "$archive" meme
+    $RATARMOUNT_CMD "$archive" >ratarmount.stdout.log 2>ratarmount.stderr.log
+    diff -- meme "$mountFolder/meme" || returnError "$LINENO" 'Files differ on simple mount!'
+    funmount "$mountFolder"
+
+    # Appending to the TAR should only index the appended members instead of recreating the whole index
+    head -c $(( 100 * 1024 )) /dev/urandom > heho
+    echo 'momo' > meme
+    tar -rf "$archive" heho meme
+
+    $RATARMOUNT_CMD "$archive" >ratarmount.stdout.log 2>ratarmount.stderr.log
+    ! 'grep' -Eqi '(warn|error)' ratarmount.stdout.log ratarmount.stderr.log ||
+        returnError "$LINENO" "Found warnings while executing: $RATARMOUNT_CMD $archive"
+    'grep' -q 'Only the new part will be indexed' ratarmount.stdout.log ||
+        returnError "$LINENO" 'The index was not extended for the appended TAR!'
+    diff -- heho "$mountFolder/heho" || returnError "$LINENO" 'Appended file differs!'
+    diff -- meme "$mountFolder/meme" || returnError "$LINENO" 'Updated file differs!'
+    [[ "$( cat "$mountFolder/meme.versions/1" )" == 'mimi' ]] ||
+        returnError "$LINENO" 'The first version of the updated file differs!'
+    funmount "$mountFolder"
+
+    cd .. || returnError "$LINENO" 'Could not cd to parent in order to clean up!'
+    rm -rf -- "$tmpFolder"
+
+    echoerr "[${FUNCNAME[0]}] Tested successfully"
+)
+
 checkUnionMount()
 (
     testsFolder="$( pwd )/tests"
@@ -634,6 +670,42 @@ checkTarEncoding()
 }
 
 
+checkParallelization()
+{
+    local archive="$1"; shift
+    local parallelization="$1"; shift
+    local fileInTar="$1"; shift
+    local correctChecksum="$1"
+
+    local mountFolder
+    mountFolder="$( mktemp -d )" || returnError "$LINENO" 'Failed to create temporary directory'
+    MOUNT_POINTS_TO_CLEANUP+=( "$mountFolder" )
+
+    # try with index recreation and then load the created index, both with the parallel decoder
+    local args=( -c -P "$parallelization" --recursive "$archive" "$mountFolder" )
+    {
+        runAndCheckRatarmount "${args[@]}" &&
+        checkStat "$mountFolder/$fileInTar" &&
+        verifyCheckSum "$mountFolder" "$fileInTar" "$archive" "$correctChecksum"
+    } || returnError "$LINENO" "$RATARMOUNT_CMD ${args[*]}"
+    funmount "$mountFolder"
+
+    local args=( -P "$parallelization" --recursive "$archive" "$mountFolder" )
+    {
+        runAndCheckRatarmount "${args[@]}" &&
+        checkStat "$mountFolder/$fileInTar" &&
+        verifyCheckSum "$mountFolder" "$fileInTar" "$archive" "$correctChecksum"
+    } || returnError "$LINENO" "$RATARMOUNT_CMD ${args[*]}"
+    funmount "$mountFolder"
+
+    rmdir "$mountFolder"
+
+    echoerr "[${FUNCNAME[0]}] Tested successfully '$fileInTar' in '$archive' with parallelization $parallelization"
+
+    return 0
+}
+
+
 recompressFile()
 {
     # Given a file it returns paths to all variants of (uncompressed, bz2, gzip, xz, zst).
@@ -744,6 +816,151 @@ benchmarkDecoderBackends()
 }
 
 
+checkInlineFiles()
+{
+    local archive="$1"; shift
+    local fileInTar="$1"; shift
+    local correctChecksum="$1"
+
+    local mountFolder
+    mountFolder="$( mktemp -d )" || returnError "$LINENO" 'Failed to create temporary directory'
+    MOUNT_POINTS_TO_CLEANUP+=( "$mountFolder" )
+
+    # create the index with inlined small files and then read them from the loaded index
+    local args=( -c --inline-file-size-limit 4K --recursive "$archive" "$mountFolder" )
+    {
+        runAndCheckRatarmount "${args[@]}" &&
+        checkStat "$mountFolder/$fileInTar" &&
+        verifyCheckSum "$mountFolder" "$fileInTar" "$archive" "$correctChecksum"
+    } || returnError "$LINENO" "$RATARMOUNT_CMD ${args[*]}"
+    funmount "$mountFolder"
+
+    # the file contents must have been read from the index instead of from the archive
+    local args=( --recursive "$archive" "$mountFolder" )
+    {
+        runAndCheckRatarmount "${args[@]}" &&
+        checkStat "$mountFolder/$fileInTar" &&
+        verifyCheckSum "$mountFolder" "$fileInTar" "$archive" "$correctChecksum" &&
+        'grep' -q '"index.inlineFileReads"' "$mountFolder/.ratarmount-stats"
+    } || returnError "$LINENO" "$RATARMOUNT_CMD ${args[*]}"
+    funmount "$mountFolder"
+
+    rmdir "$mountFolder"
+
+    echoerr "[${FUNCNAME[0]}] Tested successfully '$fileInTar' in '$archive' with inlined small files"
+
+    return 0
+}
+
+checkCompactIndex()
+{
+    local archive="$1"; shift
+    local fileInTar="$1"; shift
+    local correctChecksum="$1"
+
+    local mountFolder
+    mountFolder="$( mktemp -d )" || returnError "$LINENO" 'Failed to create temporary directory'
+    MOUNT_POINTS_TO_CLEANUP+=( "$mountFolder" )
+
+    # create the index with the compact schema and then access the files and folders from the loaded index
+    local args=( -c --compact-index --recursive "$archive" "$mountFolder" )
+    {
+        runAndCheckRatarmount "${args[@]}" &&
+        checkStat "$mountFolder/$fileInTar" &&
+        verifyCheckSum "$mountFolder" "$fileInTar" "$archive" "$correctChecksum"
+    } || returnError "$LINENO" "$RATARMOUNT_CMD ${args[*]}"
+    funmount "$mountFolder"
+
+    local indexFile="$archive.index.sqlite"
+    python3 -c "import sqlite3, sys; sqlite3.connect( sys.argv[1] ).execute( 'SELECT * FROM directories' )" \
+        "$indexFile" ||
+        returnError "$LINENO" "Index $indexFile was not created with the compact schema"
+
+    local args=( --recursive "$archive" "$mountFolder" )
+    {
+        runAndCheckRatarmount "${args[@]}" &&
+        checkStat "$mountFolder/$fileInTar" &&
+        verifyCheckSum "$mountFolder" "$fileInTar" "$archive" "$correctChecksum" &&
+        [[ -n "$( find "$mountFolder/$( dirname -- "$fileInTar" )" -mindepth 1 )" ]]
+    } || returnError "$LINENO" "$RATARMOUNT_CMD ${args[*]}"
+    funmount "$mountFolder"
+
+    rmdir "$mountFolder"
+
+    echoerr "[${FUNCNAME[0]}] Tested successfully '$fileInTar' in '$archive' with the compact index schema"
+
+    return 0
+}
+
+checkSplitArchive()
+{
+    local archive="$1"; shift
+    local fileInTar="$1"; shift
+    local correctChecksum="$1"
+
+    local mountFolder partsFolder
+    mountFolder="$( mktemp -d )" || returnError "$LINENO" 'Failed to create temporary directory'
+    partsFolder="$( mktemp -d )" || returnError "$LINENO" 'Failed to create temporary directory'
+    MOUNT_POINTS_TO_CLEANUP+=( "$mountFolder" )
+
+    # split into parts much smaller than the archive in order to test reads across part boundaries
+    split --numeric-suffixes=1 --suffix-length=3 --bytes=1K -- "$archive" "$partsFolder/$( basename -- "$archive" )."
+
+    local args=( -c --recursive --join-split-archives "$partsFolder/$( basename -- "$archive" ).001" "$mountFolder" )
+    {
+        runAndCheckRatarmount "${args[@]}" &&
+        checkStat "$mountFolder/$fileInTar" &&
+        verifyCheckSum "$mountFolder" "$fileInTar" "$archive" "$correctChecksum"
+    } || returnError "$LINENO" "$RATARMOUNT_CMD ${args[*]}"
+    funmount "$mountFolder"
+
+    rm -- "$partsFolder/"*
+    rmdir "$mountFolder" "$partsFolder"
+
+    echoerr "[${FUNCNAME[0]}] Tested successfully '$fileInTar' in split '$archive'"
+}
+
+checkExtract()
+{
+    local archive="$1"; shift
+    local fileInTar="$1"; shift
+    local correctChecksum="$1"
+
+    local extractFolder
+    extractFolder="$( mktemp -d )" || returnError "$LINENO" 'Failed to create temporary directory'
+
+    # list the file twice and after another one in order to test the reordering and deduplication
+    printf '%s\n' "$fileInTar" foo/fighter/ufo "$fileInTar" | $RATARMOUNT_CMD -c --extract - -- "$archive" "$extractFolder" ||
+        returnError "$LINENO" "$RATARMOUNT_CMD --extract - $archive $extractFolder"
+    verifyCheckSum "$extractFolder" "$fileInTar" "$archive" "$correctChecksum" ||
+        returnError "$LINENO" "Wrong checksum for extracted '$fileInTar'"
+
+    rm -r -- "$extractFolder"
+
+    echoerr "[${FUNCNAME[0]}] Tested successfully extracting '$fileInTar' from '$archive'"
+}
+
+checkExtractLink()
+{
+    local archive="$1"; shift
+    local fileInTar="$1"; shift
+    local correctLinkTarget="$1"
+
+    local extractFolder
+    extractFolder="$( mktemp -d )" || returnError "$LINENO" 'Failed to create temporary directory'
+
+    printf '%s\n' "$fileInTar" | $RATARMOUNT_CMD -c --extract - -- "$archive" "$extractFolder" ||
+        returnError "$LINENO" "$RATARMOUNT_CMD --extract - $archive $extractFolder"
+    if [[ $( readlink -- "$extractFolder/$fileInTar" ) != "$correctLinkTarget" ]]; then
+        echoerr -e "\e[37mLink target of extracted '$fileInTar' from '$archive' does not match"'!\e[0m'
+        returnError "$LINENO" "$RATARMOUNT_CMD --extract - $archive $extractFolder"
+    fi
+
+    rm -r -- "$extractFolder"
+
+    echoerr "[${FUNCNAME[0]}] Tested successfully extracting '$fileInTar' from '$archive' for link target $correctLinkTarget"
+}
+
 checkIndexPathOption()
 {
     # The --index-path should have highest priority, overwriting all --index-folders and default locations
@@ -922,6 +1139,7 @@ checkSuffixStripping()
 checkRecursiveFolderMounting()
 {
     # Do all test archive checks at once by copying them to temporary folder and recursively mounting that folder
+    # All arguments will be forwarded to ratarmount.
 
     local archiveFolder mountFolder
     archiveFolder="$( mktemp -d )" || returnError "$LINENO" 'Failed to create temporary directory'
@@ -931,7 +1149,7 @@ checkRecursiveFolderMounting()
     for (( iTest = 0; iTest < ${#tests[@]}; iTest += 3 )); do
         'cp' --no-clobber -- "${tests[iTest+1]}" "$archiveFolder"
     done
-    runAndCheckRatarmount -c --ignore-zeros --recursive "$archiveFolder" "$mountFolder"
+    runAndCheckRatarmount -c --ignore-zeros --recursive "$@" "$archiveFolder" "$mountFolder"
 
     local nChecks=0
     for (( iTest = 0; iTest < ${#tests[@]}; iTest += 3 )); do
@@ -1057,6 +1275,20 @@ checkTarEncoding tests/single-file.tar utf-8 bar d3b07384d113edec49eaa6238ad5ff0
 checkTarEncoding tests/single-file.tar latin1 bar d3b07384d113edec49eaa6238ad5ff00
 checkTarEncoding tests/special-char.tar latin1 'Datei-mit-dämlicher-Kodierung.txt' 2709a3348eb2c52302a7606ecf5860bc
 
+checkParallelization tests/2k-recursive-tars.tar.bz2 0 mimi/01333.tar/foo 8f30b20831bade7a2236edf09a55af60
+checkParallelization tests/2k-recursive-tars.tar.bz2 4 mimi/02000.tar/foo f95f8943f6dcf7b3c1c8c2cab5455f8b
+checkInlineFiles tests/2k-recursive-tars.tar.bz2 mimi/01333.tar/foo 8f30b20831bade7a2236edf09a55af60
+checkCompactIndex tests/2k-recursive-tars.tar.bz2 mimi/01333.tar/foo 8f30b20831bade7a2236edf09a55af60
+checkCompactIndex tests/nested-tar.tar foo/lighter.tar/fighter/bar 2b87e29fca6ee7f1df6c1a76cb58e101
+
+checkSplitArchive tests/2k-recursive-tars.tar.bz2 mimi/01333.tar/foo 8f30b20831bade7a2236edf09a55af60
+checkSplitArchive tests/nested-tar.tar foo/lighter.tar/fighter/bar 2b87e29fca6ee7f1df6c1a76cb58e101
+
+checkExtract tests/nested-tar.tar foo/lighter.tar 2a06cc391128d74e685a6cb7cfe9f94d
+checkExtract tests/updated-file.tar foo/fighter/ufo b3de7534cbc8b8a7270c996235d0c2da
+checkExtractLink tests/symlinks.tar foo ../foo
+checkExtractLink tests/symlinks.tar python /usr/bin/python
+
 checkLinkInTAR tests/symlinks.tar foo ../foo
 checkLinkInTAR tests/symlinks.tar python /usr/bin/python
 
@@ -1065,11 +1297,16 @@ checkFileInTARPrefix foo tests/single-nested-file.tar fighter/ufo 2709a3348eb2c5
 checkFileInTARPrefix foo/fighter tests/single-nested-file.tar ufo 2709a3348eb2c52302a7606ecf5860bc
 
 checkAutomaticIndexRecreation || returnError "$LINENO" 'Automatic index recreation test failed!'
+checkIndexAppend || returnError "$LINENO" 'Incremental index append test failed!'
 checkAutoMountPointCreation || returnError "$LINENO" 'Automatic mount point creation test failed!'
 checkUnionMount || returnError "$LINENO" 'Union mounting test failed!'
 checkUnionMountFileVersions || returnError "$LINENO" 'Union mount file version access test failed!'
 
 checkRecursiveFolderMounting
+checkRecursiveFolderMounting --lazy
+checkRecursiveFolderMounting -P 2
+checkRecursiveFolderMounting --index-memory-mode mmap
+checkRecursiveFolderMounting --index-memory-mode memory
 
 for (( iTest = 0; iTest < ${#tests[@]}; iTest += 3 )); do
     checksum=${tests[iTest]}
@@ -29,6 +29,13 @@ assert ratarmount.StenciledFile( tmpFile, [(0,2)] ).read() == b"12"
 assert ratarmount.StenciledFile( tmpFile, [(0,3)] ).read() == b"123"
 assert ratarmount.StenciledFile( tmpFile, [(0,len( testData ) )] ).read() == testData
 
+stenciledFile = ratarmount.StenciledFile( tmpFile, [(1,8)] )
+assert stenciledFile.seek( 2 ) == 2
+assert stenciledFile.read( 3 ) == b"456"
+assert stenciledFile.tell() == 5
+assert stenciledFile.read( 10 ) == b"789"
+assert stenciledFile.read( 1 ) == b""
+
 
 print( "Test StenciledFile with stencils each sized 1 byte" )
 
@@ -73,3 +80,602 @@ assert stenciledFile.tell() == 26
 assert stenciledFile.read( 1 ) == b""
 assert stenciledFile.seek( -6, io.SEEK_END ) == 0
 assert stenciledFile.read( 1 ) == b"2"
+
+print( "Test StenciledFile.readinto" )
+
+stenciledFile = ratarmount.StenciledFile( tmpFile, [(1,2),(2,2),(0,2)] )
+buffer = bytearray( 4 )
+assert stenciledFile.seek( 1 ) == 1
+assert stenciledFile.readinto( buffer ) == 4
+assert buffer == b"3341"
+assert stenciledFile.readinto( buffer ) == 1
+assert buffer[:1] == b"2"
+assert stenciledFile.readinto( buffer ) == 0
+
+stencils = [ ( i % len( testData ), 1 ) for i in range( 10000 ) ]
+assert ratarmount.StenciledFile( tmpFile, stencils ).read() == testData * 1000
+
+
+print( "Test BlockCachedFile" )
+
+cache = ratarmount.BlockCache( maxSize = 8, blockSize = 3 )
+cachedFile = ratarmount.BlockCachedFile( tmpFile, cache, 'tmpFile' )
+assert cachedFile.read( 4 ) == b"1234"
+assert cachedFile.tell() == 4
+assert cachedFile.read() == b"567890"
+assert cachedFile.seek( 2 ) == 2
+assert cachedFile.read( 5 ) == b"34567"
+assert cachedFile.seek( -1, io.SEEK_END ) == 9
+assert cachedFile.read( 5 ) == b"0"
+assert cachedFile.read( 5 ) == b""
+assert cache.size <= cache.maxSize
+assert cache.hits > 0 and cache.misses > 0
+
+otherFile = ratarmount.BlockCachedFile( tmpFile, cache, 'tmpFile' )
+hits = cache.hits
+assert otherFile.seek( 9 ) == 9
+assert otherFile.read() == b"0"
+assert cache.hits == hits + 1
+
+cache.clear()
+assert not cache.blocks and cache.size == 0 and cache.hits == 0 and cache.misses == 0
+assert otherFile.seek( 0 ) == 0
+assert otherFile.read( 2 ) == b"12"
+assert cache.misses == 1
+
+
+print( "Test BlockCachedFile with BlockPrefetcher" )
+
+cache = ratarmount.BlockCache( maxSize = 1024, blockSize = 2 )
+prefetcher = ratarmount.BlockPrefetcher( cache, 'tmpFile', lambda: ( io.BytesIO( testData ), ), prefetchCount = 2 )
+cachedFile = ratarmount.BlockCachedFile( tmpFile, cache, 'tmpFile', prefetcher )
+assert cachedFile.read( 4 ) == b"1234"
+for future in list( prefetcher.pending.values() ):
+    future.result()
+assert ( 'tmpFile', 2 ) in cache
+assert ( 'tmpFile', 3 ) in cache
+assert cachedFile.read() == b"567890"
+
+prefetcher.close()
+assert prefetcher.fileObjects is None
+cache = ratarmount.BlockCache( maxSize = 1024, blockSize = 2 )
+cachedFile = ratarmount.BlockCachedFile( tmpFile, cache, 'tmpFile', prefetcher )
+assert cachedFile.read( 4 ) == b"1234"
+assert not prefetcher.pending
+
+
+print( "Test SQLiteBlobsWriter and SQLiteBlobsFile" )
+
+import sqlite3
+connection = sqlite3.connect( ':memory:' )
+connection.execute( 'CREATE TABLE blobs ( data BLOB )' )
+with ratarmount.SQLiteBlobsWriter( connection, 'blobs', 'data', chunkSize = 4 ) as blobsWriter:
+    blobsWriter.write( testData[:3] )
+    blobsWriter.write( testData[3:] )
+    assert blobsWriter.tell() == len( testData )
+assert connection.execute( 'SELECT COUNT(*) FROM blobs' ).fetchone()[0] == 3
+assert ratarmount.SQLiteBlobsFile( connection, 'blobs', 'data' ).read() == testData
+
+blobsFile = ratarmount.SQLiteBlobsFile( connection, 'blobs', 'data' )
+assert blobsFile.read( 5 ) == testData[:5]
+assert blobsFile.tell() == 5
+assert blobsFile.read( 1 ) == testData[5:6]
+assert blobsFile.read() == testData[6:]
+
+
+print( "Test threaded access to an index only existing in memory" )
+
+import concurrent.futures
+ratarmount.printDebug = 0
+with open( os.path.join( os.path.dirname( __file__ ), 'single-file.tar' ), 'rb' ) as file:
+    indexedTar = ratarmount.SQLiteIndexedTar( fileObject = file, threaded = True )
+    def readBar( i ):
+        return indexedTar.read( '/bar', 4, 0 )
+    with concurrent.futures.ThreadPoolExecutor( 4 ) as executor:
+        assert set( executor.map( readBar, range( 100 ) ) ) == { b"foo\n" }
+    # The connection to the in-memory index can't be opened again, so it is shared by all threads.
+    assert indexedTar.sqlConnectionPool.createdCount == 1
+ratarmount.printDebug = 1
+
+
+print( "Test reading files inlined into the index" )
+
+import shutil
+ratarmount.printDebug = 0
+folder = tempfile.mkdtemp()
+shutil.copy( os.path.join( os.path.dirname( __file__ ), 'updated-file.tar' ), folder )
+tarPath = os.path.join( folder, 'updated-file.tar' )
+ratarmount.SQLiteIndexedTar( tarPath, writeIndex = True, inlineFileSizeLimit = 5 ).close()
+indexedTar = ratarmount.SQLiteIndexedTar( tarPath, writeIndex = True )
+assert indexedTar.indexInlineFileSizeLimit == 5
+inlineFileReads = ratarmount.performanceStatistics.toDict()['counters'].get( 'index.inlineFileReads', 0 )
+import tarfile
+with tarfile.open( tarPath ) as tarFile:
+    versions = [ tarFile.extractfile( member ).read() for member in tarFile.getmembers() if member.isfile() ]
+for version, contents in enumerate( versions, 1 ):
+    fileInfo = indexedTar.getFileInfo( '/foo/fighter/ufo', fileVersion = version )
+    assert indexedTar.read( '/foo/fighter/ufo', fileInfo.size, 0, fileInfo ) == contents
+# Only the last version is not larger than the limit and therefore inlined into the index.
+counters = ratarmount.performanceStatistics.toDict()['counters']
+assert counters['index.inlineFileReads'] == inlineFileReads + 1
+indexedTar.close()
+shutil.rmtree( folder )
+ratarmount.printDebug = 1
+
+
+print( "Test reading from a memory-mapped TAR after it has been truncated" )
+
+ratarmount.printDebug = 0
+folder = tempfile.mkdtemp()
+tarPath = os.path.join( folder, 'large-file.tar' )
+with tarfile.open( tarPath, 'w' ) as tarFile:
+    tarInfo = tarfile.TarInfo( 'large' )
+    tarInfo.size = 1024 * 1024
+    tarFile.addfile( tarInfo, io.BytesIO( b'1' * tarInfo.size ) )
+indexedTar = ratarmount.SQLiteIndexedTar( tarPath, writeIndex = True )
+assert indexedTar.read( '/large', 4, 0 ) == b'1111'
+assert indexedTar._tarFileMapForReading() is not None
+os.truncate( tarPath, 4096 )
+# Slicing the map would result in SIGBUS, so the truncated file must be read via the file object instead.
+assert indexedTar.read( '/large', 4, 512 * 1024 ) == b''
+assert indexedTar.read( '/large', 4, 0 ) == b'1111'
+indexedTar.close()
+shutil.rmtree( folder )
+ratarmount.printDebug = 1
+
+
+print( "Test PathBloomFilter" )
+
+paths = [ "/folder{}/file{}".format( i // 10, i ) for i in range( 1000 ) ]
+pathFilter = ratarmount.PathBloomFilter( len( paths ) )
+for path in paths:
+    pathFilter.add( path )
+assert all( path in pathFilter for path in paths )
+falsePositives = sum( "/folder{}/missing{}".format( i // 10, i ) in pathFilter for i in range( 10000 ) )
+assert falsePositives < 300
+assert "/foo" not in ratarmount.PathBloomFilter( 0 )
+
+
+print( "Test path filters only being created for union mounts of many archives" )
+
+folder = tempfile.mkdtemp()
+tarPaths = []
+for i in range( 3 ):
+    tarPaths.append( os.path.join( folder, 'archive{}.tar'.format( i ) ) )
+    with tarfile.open( tarPaths[-1], 'w' ) as tarFile:
+        tarInfo = tarfile.TarInfo( 'file{}'.format( i ) )
+        tarInfo.size = 1
+        tarFile.addfile( tarInfo, io.BytesIO( b'1' ) )
+
+ratarmount.printDebug = 0
+minArchivesForPathFilters = ratarmount.TarMount.minArchivesForPathFilters
+for minArchives, hasFilters in [ ( minArchivesForPathFilters, False ), ( 3, True ) ]:
+    ratarmount.TarMount.minArchivesForPathFilters = minArchives
+    tarMount = ratarmount.TarMount( tarPaths, os.path.join( folder, 'mounted' ) )
+    assert bool( tarMount.mergedPathFilter ) == hasFilters
+    assert all( tarMount.getattr( '/file{}'.format( i ) )['st_size'] == 1 for i in range( 3 ) )
+    assert sorted( tarMount.readdir( '/', 0 ) ) == sorted( [ '.', '..', 'file0', 'file1', 'file2' ] )
+    # Loading an index fails with "database is locked" while it is still opened by another instance
+    for mountSource in tarMount.mountSources:
+        mountSource.close()
+    del tarMount
+ratarmount.TarMount.minArchivesForPathFilters = minArchivesForPathFilters
+ratarmount.printDebug = 1
+shutil.rmtree( folder )
+
+
+print( "Test FolderMountSource._findMountedTar" )
+
+folder = tempfile.mkdtemp()
+mountSource = ratarmount.FolderMountSource( folder )
+mountSource._addMountPoint( 'a.tar', folder )
+mountSource._addMountPoint( 'a.tar/b.tar', folder )
+mountSource._addMountPoint( 'c/d/e.tar', folder )
+assert mountSource._findMountedTar( '/a.tar' ) == ( 'a.tar', '/' )
+assert mountSource._findMountedTar( '/a.tar/b.tar/f' ) == ( 'a.tar', 'b.tar/f' )
+assert mountSource._findMountedTar( '/c/d/e.tar/f/g' ) == ( 'c/d/e.tar', 'f/g' )
+assert mountSource._findMountedTar( '/c/d' ) is None
+assert mountSource._findMountedTar( '/c/d/e' ) is None
+assert mountSource._findMountedTar( '/' ) is None
+mountSource._removeMountPoint( 'a.tar' )
+assert mountSource._findMountedTar( '/a.tar/b.tar/f' ) == ( 'a.tar/b.tar', 'f' )
+os.rmdir( folder )
+
+
+print( "Test FolderMountSource closing lazily opened TARs only after their last use" )
+
+folder = tempfile.mkdtemp()
+for name in [ 'a.tar', 'b.tar' ]:
+    shutil.copy( os.path.join( os.path.dirname( __file__ ), 'single-file.tar' ), os.path.join( folder, name ) )
+ratarmount.printDebug = 0
+mountSource = ratarmount.FolderMountSource( folder, recursive = True, lazy = True, indexFolders = [ folder ] )
+maxOpenedLazyTars = ratarmount.FolderMountSource.maxOpenedLazyTars
+ratarmount.FolderMountSource.maxOpenedLazyTars = 1
+with mountSource._acquireMountedTar( 'a.tar' ) as tarA:
+    # Opening b.tar evicts a.tar, which must still be usable until it is released.
+    assert mountSource.read( '/b.tar/bar', 4, 0 ) == b"foo\n"
+    assert list( mountSource.mountedTars ) == [ 'b.tar' ]
+    assert tarA.read( '/bar', 4, 0 ) == b"foo\n"
+assert tarA.sqlConnection is None
+assert mountSource.read( '/a.tar/bar', 4, 0 ) == b"foo\n"
+assert not mountSource.tarUserCounts and not mountSource.evictedTars
+ratarmount.FolderMountSource.maxOpenedLazyTars = maxOpenedLazyTars
+ratarmount.printDebug = 1
+shutil.rmtree( folder )
+
+
+print( "Test FolderMountSource creating the indexes only once for more lazily opened TARs than can be kept open" )
+
+folder = tempfile.mkdtemp()
+tarNames = [ 'a.tar', 'b.tar', 'c.tar' ]
+for name in tarNames:
+    shutil.copy( os.path.join( os.path.dirname( __file__ ), 'single-file.tar' ), os.path.join( folder, name ) )
+createdIndexes = []
+createIndex = ratarmount.SQLiteIndexedTar._createIndex
+def countingCreateIndex( self, *args, **kwargs ):
+    createdIndexes.append( os.path.basename( self.tarFileName ) )
+    return createIndex( self, *args, **kwargs )
+ratarmount.SQLiteIndexedTar._createIndex = countingCreateIndex
+ratarmount.printDebug = 0
+maxOpenedLazyTars = ratarmount.FolderMountSource.maxOpenedLazyTars
+ratarmount.FolderMountSource.maxOpenedLazyTars = 2
+mountSource = ratarmount.FolderMountSource( folder, recursive = True, lazy = True, clearIndexCache = True,
+                                            indexFolders = [ folder ] )
+for _ in range( 3 ):
+    for name in tarNames:
+        assert mountSource.read( '/' + name + '/bar', 4, 0 ) == b"foo\n"
+assert len( mountSource.mountedTars ) == 2
+assert sorted( createdIndexes ) == tarNames
+for indexedTar in mountSource.mountedTars.values():
+    indexedTar.close()
+ratarmount.FolderMountSource.maxOpenedLazyTars = maxOpenedLazyTars
+ratarmount.SQLiteIndexedTar._createIndex = createIndex
+ratarmount.printDebug = 1
+shutil.rmtree( folder )
+
+
+print( "Test the block metadata of compressed TARs inside mounted folders" )
+
+import json
+import lzma
+folder = tempfile.mkdtemp()
+os.mkdir( os.path.join( folder, 'archives' ) )
+tarData = io.BytesIO()
+with tarfile.open( fileobj = tarData, mode = 'w' ) as tarFile:
+    for i in range( 4 ):
+        tarInfo = tarfile.TarInfo( 'file{}'.format( i ) )
+        tarInfo.size = 100000
+        tarFile.addfile( tarInfo, io.BytesIO( bytes( [ ord( 'A' ) + i ] ) * tarInfo.size ) )
+tarData = tarData.getvalue()
+# Two xz streams, so that the files span different blocks.
+with open( os.path.join( folder, 'archives', 'blocks.tar.xz' ), 'wb' ) as file:
+    file.write( lzma.compress( tarData[:len( tarData ) // 2] ) + lzma.compress( tarData[len( tarData ) // 2:] ) )
+
+ratarmount.printDebug = 0
+maxInMemorySpecialFileSize = ratarmount.TarMount.maxInMemorySpecialFileSize
+ratarmount.TarMount.maxInMemorySpecialFileSize = 100
+tarMount = ratarmount.TarMount( folder, os.path.join( folder, 'mounted' ), recursive = True, lazy = True,
+                                parallelization = 2, indexFolders = [ folder ] )
+size = tarMount.getattr( '/.ratarmount-blocks' )['st_size']
+lines = tarMount.read( '/.ratarmount-blocks', size, 0, 0 ).decode().splitlines()
+blocks = [ json.loads( line ) for line in lines ]
+assert [ block['path'] for block in blocks ] == [ '/archives/blocks.tar.xz/file{}'.format( i ) for i in range( 4 ) ]
+assert blocks[0]['archive'] == os.path.join( folder, 'archives', 'blocks.tar.xz' )
+assert blocks[0]['firstblock'] == 0 and blocks[-1]['lastblock'] == 1
+assert tarMount.read( '/.ratarmount-blocks', 10, 1, 0 ) == lines[0][1:11].encode()
+ratarmount.TarMount.maxInMemorySpecialFileSize = maxInMemorySpecialFileSize
+del tarMount
+ratarmount.printDebug = 1
+shutil.rmtree( folder )
+
+
+print( "Test PerformanceStatistics" )
+
+statistics = ratarmount.PerformanceStatistics()
+statistics.count( 'reads' )
+statistics.count( 'reads', 2 )
+statistics.countMany( { 'reads': 1, 'seeks': 2 } )
+for latency in [ 0.5e-6, 3e-6, 3e-6, 3e-6, 1e-3 ]:
+    statistics.addLatency( 'read', latency )
+result = statistics.toDict()
+assert result['counters'] == { 'reads': 4, 'seeks': 2 }
+assert result['latencies']['read']['count'] == 5
+assert result['latencies']['read']['histogramUs'] == { '1': 1, '4': 3, '1024': 1 }
+assert result['latencies']['read']['p50Us'] == 4
+assert result['latencies']['read']['p99Us'] == 1024
+
+@ratarmount.timedOperation( 'generator' )
+def generateNumbers():
+    yield 1
+    yield 2
+
+assert list( generateNumbers() ) == [ 1, 2 ]
+assert ratarmount.performanceStatistics.toDict()['latencies']['generator']['count'] == 1
+
+
+print( "Test TarHeaderScanner against tarfile" )
+
+import glob
+import gzip
+import tarfile
+for tarPath in glob.glob( os.path.join( os.path.dirname( os.path.abspath( __file__ ) ), '*.tar' ) ):
+    attributes = [ 'name', 'offset', 'offset_data', 'size', 'mtime', 'mode', 'type', 'linkname', 'uid', 'gid' ]
+    with open( tarPath, 'rb' ) as file:
+        expected = [ [ getattr( m, a ) for a in attributes ] for m in tarfile.open( fileobj = file, mode = 'r:' ) ]
+    with open( tarPath, 'rb' ) as file:
+        scanned = [ [ getattr( m, a ) for a in attributes ] for m in ratarmount.TarHeaderScanner( file ) ]
+    assert scanned == expected, tarPath
+    with open( tarPath, 'rb' ) as file:
+        gzipData = gzip.compress( file.read() )
+    with gzip.GzipFile( fileobj = io.BytesIO( gzipData ) ) as gzipFile:
+        scanned = [ [ getattr( m, a ) for a in attributes ]
+                    for m in ratarmount.TarHeaderScanner( gzipFile, streaming = True ) ]
+    assert scanned == expected, tarPath
+
+with open( os.path.join( os.path.dirname( os.path.abspath( __file__ ) ), 'single-file.tar' ), 'rb' ) as file:
+    truncatedTar = file.read( 512 )
+with gzip.GzipFile( fileobj = io.BytesIO( gzip.compress( truncatedTar + b"foo" ) ) ) as gzipFile:
+    scanner = ratarmount.TarHeaderScanner( gzipFile, streaming = True )
+    try:
+        list( scanner )
+        assert False, "Expected an error for the truncated TAR"
+    except tarfile.ReadError as exception:
+        assert 'unexpected end of data' in str( exception )
+
+
+print( "Test GzipIndex" )
+
+for version in [ 0, 1 ]:
+    points = [ ( 10, 0, 0, None if version == 0 else b"w" * 4 ), ( 20, 100, 3, b"x" * 4 ), ( 30, 200, 5, b"y" * 4 ) ]
+    gzipIndex = ratarmount.GzipIndex( version, 0, 40, 300, 100, 4, points )
+    serialized = io.BytesIO()
+    gzipIndex.write( serialized )
+    serialized.seek( 0 )
+    readIndex = ratarmount.GzipIndex.read( serialized )
+    assert readIndex.points == points
+    assert ( readIndex.compressedSize, readIndex.uncompressedSize, readIndex.spacing ) == ( 40, 300, 100 )
+    assert serialized.read() == b""
+
+gzipIndex = ratarmount.GzipIndex( 1, 0, 40, 300, 100, 4, [ ( 10, 0, 0, None ), ( 30, 200, 5, b"y" * 4 ) ] )
+assert gzipIndex.addPoints( [ ( 20, 100, 3, b"x" * 4 ), ( 31, 200, 0, None ) ] ) == 1
+assert [ point[1] for point in gzipIndex.points ] == [ 0, 100, 200 ]
+assert gzipIndex.points[2][0] == 30
+
+
+print( "Test adding gzip seek points to hot regions in the background" )
+
+if 'indexed_gzip' not in sys.modules:
+    print( "Skipping the test because indexed_gzip is not installed." )
+else:
+    import random
+    ratarmount.printDebug = 0
+    folder = tempfile.mkdtemp()
+    tarPath = os.path.join( folder, 'random.tar.gz' )
+    random.seed( 0 )
+    contents = bytes( random.getrandbits( 8 ) for _ in range( 4 * 1024 * 1024 ) )
+    with tarfile.open( tarPath, 'w:gz' ) as tarFile:
+        tarInfo = tarfile.TarInfo( 'random' )
+        tarInfo.size = len( contents )
+        tarFile.addfile( tarInfo, io.BytesIO( contents ) )
+    options = { 'writeIndex': True, 'gzipSeekPointSpacing': 1024 * 1024, 'gzipDenseSeekPointSpacing': 128 * 1024 }
+    indexedTar = ratarmount.SQLiteIndexedTar( tarPath, **options )
+    for offset in [ 1500 * 1024, 1700 * 1024, 1600 * 1024 ]:
+        assert indexedTar.read( '/random', 1024, offset ) == contents[offset : offset + 1024]
+    # Waits for the background thread adding the seek points.
+    indexedTar.close()
+
+    with sqlite3.connect( tarPath + '.index.sqlite' ) as connection:
+        offsets = [ row[0] for row in connection.execute( 'SELECT uncompressedoffset FROM gzipseekpoints;' ) ]
+    assert offsets
+    indexedTar = ratarmount.SQLiteIndexedTar( tarPath, **options )
+    for offset in [ 0, 1500 * 1024, 3 * 1024 * 1024 ]:
+        assert indexedTar.read( '/random', 1024, offset ) == contents[offset : offset + 1024]
+    indexedTar.close()
+    shutil.rmtree( folder )
+    ratarmount.printDebug = 1
+
+
+print( "Test findZstdFrameOffsets" )
+
+import struct
+def rawZstdFrame( data ):
+    # Single segment frame with a 1 B frame content size and one raw block without compression
+    return struct.pack( '<IBB', 0xFD2FB528, 0x20, len( data ) ) + ( ( len( data ) << 3 ) | 1 ).to_bytes( 3, 'little' ) + data
+
+frames = [ rawZstdFrame( b"foo" ), rawZstdFrame( b"" ), rawZstdFrame( b"barbara" ) ]
+expectedOffsets = { 0: 0, 12: 3, 21: 3, 37: 10 }
+skippableFrame = struct.pack( '<II', 0x184D2A50, 4 ) + b"size"
+assert ratarmount.findZstdFrameOffsets( io.BytesIO( b"".join( frames ) ) ) == expectedOffsets
+assert ratarmount.findZstdFrameOffsets( io.BytesIO( skippableFrame + b"".join( frames ) ) ) == {
+    offset + len( skippableFrame ) : size for offset, size in expectedOffsets.items() }
+assert ratarmount.findZstdFrameOffsets( io.BytesIO( b"".join( frames )[:-1] ) ) is None
+# The scan stops at the first frame larger than the ones the parallel decoder is used for
+assert ratarmount.findZstdFrameOffsets( io.BytesIO( b"".join( frames ) ), maxFrameSize = 7 ) == expectedOffsets
+assert ratarmount.findZstdFrameOffsets( io.BytesIO( b"".join( frames ) ), maxFrameSize = 6 ) is None
+
+seekTableEntries = b"".join( struct.pack( '<II', len( frame ), frame[5] ) for frame in frames )
+seekTable = struct.pack( '<II', 0x184D2A5E, len( seekTableEntries ) + 9 ) + seekTableEntries
+seekTable += struct.pack( '<IBI', len( frames ), 0, 0x8F92EAB1 )
+seekableFile = io.BytesIO( b"".join( frames ) + seekTable )
+seekableFile.seek( 5 )
+assert ratarmount.findZstdFrameOffsets( seekableFile ) == expectedOffsets
+assert seekableFile.tell() == 5
+
+
+print( "Test ParallelZstdFile" )
+
+# The frames are decoded from in-memory file objects, which older indexed_zstd versions do not accept.
+if 'indexed_zstd' not in sys.modules:
+    print( "Skipping test because the indexed_zstd module is not available." )
+else:
+    zstdFile = ratarmount.ParallelZstdFile( io.BytesIO( b"".join( frames ) ), expectedOffsets, parallelization = 2 )
+    assert zstdFile.read() == b"foobarbara"
+    assert zstdFile.seek( 2 ) == 2
+    assert zstdFile.read( 3 ) == b"oba"
+    zstdFile.close()
+
+
+print( "Test opening bzip2 files without a file descriptor" )
+
+# Remote and joined split archives have no file descriptor and are opened as file objects, which older
+# indexed_bzip2 versions do not accept.
+if 'indexed_bzip2' not in sys.modules:
+    print( "Skipping test because the indexed_bzip2 module is not available." )
+else:
+    import bz2
+    for parallelization in [ 1, 2 ]:
+        bz2File = ratarmount.SQLiteIndexedTar._openDecompressor(
+            io.BytesIO( bz2.compress( b"foobarbara" ) ), 'bz2', 16 * 1024 * 1024, parallelization )
+        assert bz2File.read() == b"foobarbara"
+        bz2File.close()
+
+
+print( "Test readXzBlocks and ParallelXzFile" )
+
+import lzma
+xzData = lzma.compress( b"foo" ) + b"\0" * 4 + lzma.compress( b"barbara", check = lzma.CHECK_NONE )
+blocks = ratarmount.readXzBlocks( io.BytesIO( xzData ) )
+assert [ block.uncompressedsize for block in blocks ] == [ 3, 7 ]
+assert blocks[0].offset == 12
+
+xzFile = ratarmount.ParallelXzFile( io.BytesIO( xzData ), blocks, parallelization = 2 )
+assert xzFile.block_boundaries == [ 0, 3 ]
+assert xzFile.read() == b"foobarbara"
+assert xzFile.seek( 2 ) == 2
+assert xzFile.read( 3 ) == b"oba"
+xzFile.close()
+
+
+print( "Test RemoteFile" )
+
+import hashlib
+import http.server
+import socketserver
+import threading
+
+class RangeRequestHandler( http.server.BaseHTTPRequestHandler ):
+    files = {}
+    requests = []
+    # Emulates servers, which do not support conditional requests
+    ignoreIfMatch = False
+
+    def do_GET( self ):
+        data = self.files.get( self.path.split( '?' )[0] )
+        if data is None:
+            self.send_error( 404 )
+            return
+        etag = '"{}"'.format( hashlib.md5( data ).hexdigest() )
+        if not self.ignoreIfMatch and self.headers.get( 'If-Match', etag ) != etag:
+            self.send_error( 412 )
+            return
+        begin, end = [ int( x ) for x in self.headers['Range'].split( '=' )[1].split( '-' ) ]
+        RangeRequestHandler.requests.append( ( self.path, begin, end ) )
+        self.send_response( 206 )
+        self.send_header( 'Content-Range', 'bytes {}-{}/{}'.format( begin, min( end, len( data ) - 1 ), len( data ) ) )
+        self.send_header( 'Content-Length', str( min( end + 1, len( data ) ) - begin ) )
+        self.send_header( 'Last-Modified', 'Wed, 01 Jan 2020 00:00:00 GMT' )
+        self.send_header( 'ETag', etag )
+        self.end_headers()
+        self.wfile.write( data[begin : end + 1] )
+
+    def log_message( self, format, *args ):
+        pass
+
+# http.server.ThreadingHTTPServer only exists since Python 3.7
+class ThreadingHTTPServer( socketserver.ThreadingMixIn, http.server.HTTPServer ):
+    daemon_threads = True
+
+server = ThreadingHTTPServer( ( '127.0.0.1', 0 ), RangeRequestHandler )
+threading.Thread( target = server.serve_forever, daemon = True ).start()
+serverUrl = 'http://127.0.0.1:{}'.format( server.server_address[1] )
+
+remoteData = os.urandom( 100 * 1000 )
+RangeRequestHandler.files['/data.bin'] = remoteData
+with open( os.path.join( os.path.dirname( __file__ ), 'single-file.tar' ), 'rb' ) as file:
+    RangeRequestHandler.files['/single-file.tar'] = file.read()
+
+remoteCacheFolder = tempfile.mkdtemp()
+cacheFolder = ratarmount.RemoteFile.cacheFolder
+chunkSize = ratarmount.RemoteFile.chunkSize
+cacheSize = ratarmount.RemoteFile.cacheSize
+ratarmount.RemoteFile.cacheFolder = remoteCacheFolder
+ratarmount.RemoteFile.chunkSize = 4096
+ratarmount.RemoteFile.cacheSize = 1024 * 1024
+
+remoteFile = ratarmount.RemoteFile( serverUrl + '/data.bin?signature=123' )
+assert ratarmount.statPath( serverUrl + '/data.bin' ).st_size == len( remoteData )
+for offset, size in [ ( 10, 100 ), ( 50000, 20000 ), ( len( remoteData ) - 5, 100 ), ( 4095, 2 ) ]:
+    assert remoteFile.seek( offset ) == offset
+    assert remoteFile.read( size ) == remoteData[offset : offset + size]
+# The 5 chunks of the second read are fetched with one request.
+assert len( RangeRequestHandler.requests ) <= 6
+remoteFile.seek( 0 )
+assert remoteFile.read() == remoteData
+
+# A new instance, e.g., after remounting, reads all chunks from the cache folder. Only the metadata is requested.
+del RangeRequestHandler.requests[:]
+ratarmount.RemoteFile._metadata.clear()
+remoteFile = ratarmount.RemoteFile( serverUrl + '/data.bin?signature=456' )
+assert remoteFile.read() == remoteData
+assert len( RangeRequestHandler.requests ) == 1
+
+indexFolder = tempfile.mkdtemp()
+indexedTar = ratarmount.SQLiteIndexedTar( serverUrl + '/single-file.tar', writeIndex = True,
+                                          indexFolders = [ '', indexFolder ] )
+assert indexedTar.getFileInfo( '/bar' ).size == 4
+assert indexedTar.indexFileName.startswith( indexFolder )
+# The chunks only read for creating the index are not kept in the on-disk cache.
+assert not os.path.exists( indexedTar.tarFileObject.chunkFolder )
+indexedTar.close()
+
+# An index next to the remote archive is downloaded and used instead of creating a new one.
+with open( indexedTar.indexFileName, 'rb' ) as file:
+    RangeRequestHandler.files['/single-file.tar.index.sqlite'] = file.read()
+os.remove( indexedTar.indexFileName )
+indexedTar = ratarmount.SQLiteIndexedTar( serverUrl + '/single-file.tar', writeIndex = True,
+                                          indexFolders = [ '', indexFolder ] )
+assert indexedTar.indexFileName.startswith( remoteCacheFolder )
+assert indexedTar.getFileInfo( '/bar' ).size == 4
+indexedTar.close()
+
+# Chunks of a remote object, which changed after opening it, must not be mixed with the already fetched ones.
+for ignoreIfMatch in [ False, True ]:
+    RangeRequestHandler.ignoreIfMatch = ignoreIfMatch
+    remotePath = '/changing-{}.bin'.format( ignoreIfMatch )
+    RangeRequestHandler.files[remotePath] = remoteData
+    remoteFile = ratarmount.RemoteFile( serverUrl + remotePath )
+    assert remoteFile.read( 100 ) == remoteData[:100]
+    RangeRequestHandler.files[remotePath] = remoteData[::-1]
+    remoteFile.seek( 50000 )
+    try:
+        remoteFile.read( 100 )
+        assert False, "Reading a changed remote object should fail"
+    except ratarmount.RemoteError:
+        pass
+    # The changed object gets opened when opening the URL again and the chunks of the old version are deleted.
+    changedFile = ratarmount.RemoteFile( serverUrl + remotePath )
+    assert changedFile.read( 100 ) == remoteData[::-1][:100]
+    assert not os.path.exists( remoteFile.chunkFolder )
+    assert os.listdir( os.path.dirname( changedFile.chunkFolder ) ) == [ os.path.basename( changedFile.chunkFolder ) ]
+RangeRequestHandler.ignoreIfMatch = False
+
+# The least recently used chunks are evicted when the on-disk cache gets larger than cacheSize.
+ratarmount.RemoteFile.cacheSize = 10 * 4096
+remoteFile = ratarmount.RemoteFile( serverUrl + '/data.bin?signature=789' )
+remoteFile.seek( 50000 )
+assert remoteFile.read( 1000 ) == remoteData[50000:51000]
+remoteFile = ratarmount.RemoteFile( serverUrl + '/changing-False.bin' )
+assert remoteFile.read() == remoteData[::-1]
+cachedChunks = ratarmount.RemoteFile._listCachedChunks()
+assert sum( size for _, size, _ in cachedChunks ) <= ratarmount.RemoteFile.cacheSize
+assert os.path.exists( remoteFile._chunkPath( len( remoteData ) // 4096 ) )
+
+server.shutdown()
+server.server_close()
+ratarmount.RemoteFile.cacheFolder = cacheFolder
+ratarmount.RemoteFile.chunkSize = chunkSize
+ratarmount.RemoteFile.cacheSize = cacheSize
+ratarmount.RemoteFile._metadata.clear()
+ratarmount.RemoteFile._cacheUsage = None
+shutil.rmtree( remoteCacheFolder )
+shutil.rmtree( indexFolder )